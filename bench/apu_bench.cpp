@@ -0,0 +1,65 @@
+/* Measures how many samples the APU synthesizes per second with all four channels playing. Like a game, a new note is
+   played on each channel every frame, so the recorded register writes are applied in between the samples.
+
+   Usage: apu_bench [seconds of audio, default 600] */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "apu/APU.hpp"
+#include "apu/NullAudioSink.hpp"
+#include "ppu/LCD.hpp"
+
+
+int main(int argc, char *argv[])
+{
+    const uint64_t seconds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 600;
+    const uint64_t t_cycles = seconds * APU::CLOCK_RATE;
+
+    uint64_t clock = 0;
+    auto sink = std::make_unique<NullAudioSink>();
+    const NullAudioSink &samples = *sink;
+    APU apu(clock, std::move(sink));
+
+    // turn the APU on with every channel on both outputs at full volume, fill the wave RAM with a triangle
+    std::pair<uint16_t, uint8_t> setup[] = { { 0xFF26, 0x80 }, { 0xFF24, 0x77 }, { 0xFF25, 0xFF }, { 0xFF10, 0x15 },
+                                             { 0xFF1A, 0x80 }, { 0xFF1C, 0x20 }, { 0xFF22, 0x35 } };
+    for (auto [addr, value] : setup)
+        apu.write_memory(addr, value);
+    for (uint8_t i = 0; i < 16; ++i)
+        apu.write_memory(uint16_t(0xFF30 + i), uint8_t(i < 8 ? i * 0x22 : (15 - i) * 0x22));
+
+    // a note per channel and frame: envelope, period and trigger
+    auto play_notes = [&apu](uint8_t note) {
+        std::pair<uint16_t, uint8_t> notes[] = {
+            { 0xFF12, 0xF3 }, { 0xFF13, uint8_t(note * 8) }, { 0xFF14, 0x86 },
+            { 0xFF17, 0xA2 }, { 0xFF18, uint8_t(note * 4) }, { 0xFF19, 0x85 },
+            { 0xFF1D, uint8_t(note * 2) }, { 0xFF1E, 0x86 },
+            { 0xFF21, 0xF1 }, { 0xFF23, 0x80 },
+        };
+        for (auto [addr, value] : notes)
+            apu.write_memory(addr, value);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t next_frame = 0;
+    uint8_t note = 0;
+    while (clock < t_cycles) {
+        clock += APU::BATCH_T_CYCLES;
+        for (; next_frame < clock; next_frame += LCD::FRAME_T_CYCLES) {
+            uint64_t batch_end = std::exchange(clock, next_frame);
+            play_notes(note++);
+            clock = batch_end;
+        }
+        apu.synthesize();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double sample_count = double(samples.sample_count());
+    std::cout << samples.sample_count() << " stereo samples (" << seconds << " s of audio) in " << elapsed.count() << " s\n"
+              << sample_count / elapsed.count() / 1e6 << " million samples/s ("
+              << double(seconds) / elapsed.count() << "x real time)\n";
+}
@@ -0,0 +1,173 @@
+/* Measures the cost of an access through the MMU: the page table is compared with the linear search over all
+   components the MMU used before, on the same memory map and the same accesses.
+
+   Usage: mmu_bench [accesses in millions, default 200] */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+#include "mmu/MMU.hpp"
+#include "mmu/RAM.hpp"
+
+
+namespace {
+
+/* Memory that can only be accessed through `read_memory`/`write_memory`, like the registers of a component. */
+class Registers : public Memory {
+    std::vector<std::pair<uint16_t, uint16_t>> ranges_;     // both begin and end are included
+    std::vector<uint8_t> memory_ = std::vector<uint8_t>(0x10000, 0x00);
+
+    public:
+    Registers(std::initializer_list<std::pair<uint16_t, uint16_t>> ranges) : ranges_(ranges) { }
+
+    bool contains_address(uint16_t addr) const override
+    {
+        return std::ranges::any_of(ranges_, [addr](auto range) { return range.first <= addr and addr <= range.second; });
+    }
+
+    uint8_t read_memory(uint16_t addr) override { return memory_[addr]; }
+    void write_memory(uint16_t addr, uint8_t value) override { memory_[addr] = value; }
+};
+
+/* Fixed ROM: reads go straight to the backing memory, writes are bank switches. */
+class ROM : public Registers {
+    std::vector<uint8_t> rom_ = std::vector<uint8_t>(0x4000, 0x00);
+
+    public:
+    ROM() : Registers({ { 0x0000, 0x7FFF } }) { }
+    const uint8_t *read_ptr(uint16_t addr) override { return addr < 0x4000 ? &rom_[addr] : nullptr; }
+};
+
+/* The MMU before the page table: every access searches the components in the order they were added. */
+class LinearMMU : public MMU {
+    std::vector<Memory *> memory_;
+
+    Memory *find(uint16_t addr) const
+    {
+        auto it = std::find_if(memory_.begin(), memory_.end(), [addr](Memory *m) { return m->contains_address(addr); });
+        return it == memory_.end() ? nullptr : *it;
+    }
+
+    public:
+    void add(Memory *memory) { memory_.push_back(memory); }
+
+    uint8_t read_memory(uint16_t addr) override
+    {
+        Memory *m = find(addr);
+        return m ? m->read_memory(addr) : 0xFF;
+    }
+
+    void write_memory(uint16_t addr, uint8_t value) override
+    {
+        if (Memory *m = find(addr))
+            m->write_memory(addr, value);
+    }
+};
+
+/* The I/O registers games access most: joypad, DIV/TIMA, IF, the LCD registers and IE. */
+constexpr std::array<uint16_t, 12> IO_REGISTERS = { 0xFF00, 0xFF04, 0xFF05, 0xFF0F, 0xFF40, 0xFF41, 0xFF42, 0xFF43,
+                                                    0xFF44, 0xFF45, 0xFF47, 0xFFFF };
+
+struct Access {
+    uint16_t addr;
+    bool write;
+};
+
+/* Accesses like those of the CPU: the instructions are fetched from ROM one after another with a jump every few
+   instructions, a third of the instructions access WRAM, the stack in HRAM, VRAM or an I/O register. */
+std::vector<Access> make_accesses()
+{
+    std::mt19937 rng(1);
+    auto in = [&rng](int begin, int end) { return std::uniform_int_distribution<int>(begin, end)(rng); };
+
+    std::vector<Access> accesses;
+    uint16_t pc = 0x0150;
+    while (accesses.size() < 1 << 16) {
+        for (int n = in(1, 3); n > 0; --n)
+            accesses.push_back({ uint16_t(pc++ & 0x7FFF), false });
+        if (in(0, 7) == 0)
+            pc = uint16_t(in(0x0000, 0x7FFF));
+
+        if (in(0, 2) != 0)
+            continue;
+        bool write = in(0, 2) == 0;
+        switch (in(0, 9)) {
+            case 0: case 1: case 2: case 3:
+                accesses.push_back({ uint16_t(in(0xC000, 0xDFFF)), write });
+                break;
+            case 4: case 5: case 6:
+                accesses.push_back({ uint16_t(in(0xFF80, 0xFFFE)), write });
+                break;
+            case 7:
+                accesses.push_back({ uint16_t(in(0x8000, 0x9FFF)), write });
+                break;
+            default:
+                accesses.push_back({ IO_REGISTERS[in(0, IO_REGISTERS.size() - 1)], write });
+                break;
+        }
+    }
+    accesses.resize(1 << 16);
+    return accesses;
+}
+
+volatile uint32_t sink;    // keeps the reads from being optimized away
+
+/* Returns the nanoseconds per access. */
+double measure(MMU &mmu, const std::vector<Access> &accesses, uint64_t count)
+{
+    uint32_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; ++i) {
+        const Access &a = accesses[i & (accesses.size() - 1)];
+        if (a.write)
+            mmu.write_memory(a.addr, uint8_t(sum));
+        else
+            sum += mmu.read_memory(a.addr);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = sum;
+    return elapsed.count() / double(count);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    const uint64_t count = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200) * 1'000'000;
+
+    // the components (and their address ranges) in the order `YumeBoy` adds them
+    Registers dma({ { 0xFF46, 0xFF46 } });
+    Registers cpu({ { 0xFF0F, 0xFF0F }, { 0xFFFF, 0xFFFF } });
+    ROM cartridge;
+    Registers ppu({ { 0x8000, 0x9FFF }, { 0xFE00, 0xFE9F }, { 0xFF40, 0xFF45 }, { 0xFF47, 0xFF4B } });
+    Registers apu({ { 0xFF10, 0xFF26 }, { 0xFF30, 0xFF3F } });
+    RAM hram(0xFF80, 0xFFFE);
+    RAM wram(0xC000, 0xDFFF);
+    Registers serial({ { 0xFF01, 0xFF02 } });
+    Registers joypad({ { 0xFF00, 0xFF00 } });
+    Registers timer({ { 0xFF04, 0xFF07 } });
+    std::vector<Memory *> components = { &dma, &cpu, &cartridge, &ppu, &apu, &hram, &wram, &serial, &joypad, &timer };
+
+    MMU page_table;
+    LinearMMU linear;
+    for (Memory *m : components) {
+        page_table.add(m);
+        linear.add(m);
+    }
+
+    auto accesses = make_accesses();
+    measure(page_table, accesses, count / 10);  // warm-up
+    double page_table_ns = measure(page_table, accesses, count);
+    double linear_ns = measure(linear, accesses, count);
+
+    std::cout << count << " accesses\n"
+              << "page table:    " << page_table_ns << " ns/access\n"
+              << "linear search: " << linear_ns << " ns/access (" << linear_ns / page_table_ns << "x)\n";
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/** Counts the accesses to an address range that hint at missing emulation, e.g. to unmapped addresses, instead of
+ * logging every single one. An access costs an increment of its counter, only the first `LOGGED_ACCESSES` accesses to
+ * each address between two summaries are logged (see `summarize`). */
+class AccessCounters {
+    public:
+    enum class Access : uint8_t {
+        Read,
+        Write,
+    };
+
+    static constexpr uint32_t LOGGED_ACCESSES = 3;
+
+    private:
+    std::string name_;
+    uint16_t begin_;
+    size_t size_;
+    /* The accesses to each address since the last summary, reads and writes of an address are next to each other. The
+       counters are atomic so the summary can be taken on another thread than the emulation. */
+    std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+
+    std::atomic<uint32_t> &counter(Access access, uint16_t addr) const
+    {
+        return counters_[size_t(addr - begin_) * 2 + std::to_underlying(access)];
+    }
+
+    [[gnu::cold]] void log(Access access, uint16_t addr, uint8_t value, uint32_t count) const
+    {
+        if (access == Access::Read)
+            std::cerr << std::format("Address {:#06X} ({}) is read from", addr, name_);
+        else
+            std::cerr << std::format("Value {:#04X} is written to address {:#06X} ({})", value, addr, name_);
+        std::cerr << (count == LOGGED_ACCESSES ? ", further accesses are only counted until the next summary\n" : "\n");
+    }
+
+    public:
+    AccessCounters(std::string name, uint16_t begin, uint16_t end)
+        : name_(std::move(name)), begin_(begin), size_(size_t(end - begin) + 1),
+          counters_(std::make_unique<std::atomic<uint32_t>[]>(size_ * 2)) { }
+
+    /* Counts an access to the given address (the value is only logged for writes). */
+    void count(Access access, uint16_t addr, uint8_t value = 0)
+    {
+        uint32_t count = counter(access, addr).fetch_add(1, std::memory_order_relaxed) + 1;
+        if (count <= LOGGED_ACCESSES) [[unlikely]]
+            log(access, addr, value, count);
+    }
+
+    /* The accesses to the given address since the last summary. */
+    uint32_t accesses(Access access, uint16_t addr) const
+    {
+        return counter(access, addr).load(std::memory_order_relaxed);
+    }
+
+    /* Writes a line for every address that has been accessed since the last summary and starts counting (and logging)
+       anew. Returns the number of accesses. */
+    uint64_t summarize(std::ostream &out)
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < size_; ++i)
+        {
+            auto addr = uint16_t(begin_ + i);
+            uint32_t reads = counter(Access::Read, addr).exchange(0, std::memory_order_relaxed);
+            uint32_t writes = counter(Access::Write, addr).exchange(0, std::memory_order_relaxed);
+            if (reads == 0 and writes == 0) continue;
+
+            out << std::format("  {:#06X} ({}): {} reads, {} writes\n", addr, name_, reads, writes);
+            total += reads + writes;
+        }
+        return total;
+    }
+};
+
+/** Collects the access counters of the components and summarizes them periodically (see `YumeBoy`). */
+class Diagnostics {
+    std::vector<std::reference_wrapper<AccessCounters>> counters_;
+
+    public:
+    static constexpr uint64_t SUMMARY_T_CYCLES = uint64_t(1 << 22) * 10;  // every 10 seconds of emulated time
+
+    void add(AccessCounters &counters) { counters_.emplace_back(counters); }
+
+    /* Writes the accesses counted since the last summary, nothing if there were none. */
+    void summarize(std::ostream &out = std::cerr)
+    {
+        std::ostringstream lines;
+        uint64_t total = 0;
+        for (AccessCounters &counters : counters_)
+            total += counters.summarize(lines);
+        if (total != 0)
+            out << std::format("Diagnostics: {} accesses to unmapped addresses since the last summary\n", total) << lines.str();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "serial/LinkPort.hpp"
+#include "serial/Serial.hpp"
+#include "YumeBoy.hpp"
+
+
+/** Connects the serial ports of two Game Boys and runs both at the same time, each on its own thread. Instead of
+ * synchronizing every T-cycle, each Game Boy runs a quantum of T-cycles at a time and only waits for the other one if
+ * it would get more than a quantum ahead. The transfers are stamped with the T-cycle they complete at:
+ * - The Game Boy with the internal clock waits for the byte of the other one at the end of its transfer, unless the
+ *   other one has already run past it.
+ * - The other Game Boy receives the transfer at the end of its quantum and completes it at the stamped T-cycle. With a
+ *   quantum larger than `EXACT_QUANTUM`, the transfer may arrive late. It then completes as soon as the other Game Boy
+ *   requests a transfer with the external clock, and the byte it sends back arrives at the end of a quantum. If the
+ *   other Game Boy starts a transfer with the internal clock instead or none within the length of a transfer, it
+ *   sends back 0xFF.
+ * Both Game Boys have to start at the same point, e.g. after loading the ROMs or the save states of a linked session. */
+class LinkCable {
+    YumeBoy &first_;
+    YumeBoy &second_;
+    LinkPort first_port_;
+    LinkPort second_port_;
+    uint64_t quantum_;
+
+    /* Runs one Game Boy up to the given T-cycle in quanta, then keeps receiving the bytes sent over the cable until
+       the other Game Boy has finished as well. */
+    void run(YumeBoy &yume_boy, LinkPort &port, uint64_t end, std::atomic<int> &running)
+    {
+        while (yume_boy.t_cycles() < end) {
+            // the quanta of both Game Boys end at the same T-cycles
+            uint64_t quanta = (yume_boy.t_cycles() - port.origin()) / quantum_ + 1;
+            uint64_t next = std::min(end, port.origin() + quanta * quantum_);
+            while (port.peer_t_cycle() + quantum_ < next) {
+                yume_boy.poll_link();
+                std::this_thread::yield();
+            }
+
+            yume_boy.run(next - yume_boy.t_cycles());
+            port.publish(yume_boy.t_cycles());
+            yume_boy.poll_link();
+        }
+
+        running.fetch_sub(1, std::memory_order_acq_rel);
+        while (running.load(std::memory_order_acquire) > 0) {
+            yume_boy.poll_link();
+            std::this_thread::yield();
+        }
+    }
+
+    public:
+    /* With a quantum of at most half a transfer, every transfer is received before it completes and completes at its
+       exact T-cycle on both Game Boys. */
+    static constexpr uint64_t EXACT_QUANTUM = 4 * Serial::BIT_T_CYCLES;
+
+    LinkCable(YumeBoy &first, YumeBoy &second, uint64_t quantum = EXACT_QUANTUM)
+        : first_(first), second_(second), quantum_(std::max<uint64_t>(quantum, 1))
+    {
+        LinkPort::connect(first_port_, first_.t_cycles(), second_port_, second_.t_cycles());
+        first_port_.publish(first_.t_cycles());
+        second_port_.publish(second_.t_cycles());
+        first_.connect(&first_port_);
+        second_.connect(&second_port_);
+    }
+
+    LinkCable(const LinkCable &) = delete;
+    LinkCable &operator=(const LinkCable &) = delete;
+
+    ~LinkCable()
+    {
+        first_.connect(nullptr);
+        second_.connect(nullptr);
+    }
+
+    /* The number of T-cycles the Game Boys may run apart. Larger quanta let them wait for each other less often, at the
+       cost of transfers completing late if it is larger than `EXACT_QUANTUM`. Only changed in between runs. */
+    uint64_t quantum() const { return quantum_; }
+    void quantum(uint64_t t_cycles) { quantum_ = std::max<uint64_t>(t_cycles, 1); }
+
+    /* Runs both Game Boys for the given number of T-cycles, the second one on the calling thread. */
+    void run(uint64_t t_cycles)
+    {
+        std::atomic<int> running = 2;
+        first_port_.active(true);
+        second_port_.active(true);
+        {
+            std::jthread first([&] { run(first_, first_port_, first_.t_cycles() + t_cycles, running); });
+            run(second_, second_port_, second_.t_cycles() + t_cycles, running);
+        }
+        first_port_.active(false);
+        second_port_.active(false);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+/** Keeps track of the upcoming events of the components that are not ticked in lock-step with the CPU, so they only
+ * have to be caught up when something observable happens. Events are ordered by the T-cycle they are due at. */
+class Scheduler {
+    public:
+    enum class EVENT : uint8_t {
+        PPU,            // the PPU might request an interrupt (mode change or next scanline)
+        TIMER,          // the timer interrupt is requested
+        SERIAL,         // the serial interrupt is requested (a transfer completes)
+        AUDIO,          // the next batch of audio samples has to be synthesized
+        DIAGNOSTICS,    // the diagnostic counters are summarized
+
+        COUNT
+    };
+
+    static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+
+    private:
+    struct Entry {
+        uint64_t time;
+        EVENT event;
+    };
+
+    /* Min-heap of all scheduled events. Rescheduling an event does not remove its old entry, entries that do not match
+       the event's current due time in `due_` are stale and skipped. */
+    std::vector<Entry> heap_;
+    std::array<uint64_t, std::to_underlying(EVENT::COUNT)> due_;
+
+    /* Removes stale entries from the top of the heap. */
+    void drop_stale()
+    {
+        while (not heap_.empty() and heap_.front().time != due_[std::to_underlying(heap_.front().event)]) {
+            std::ranges::pop_heap(heap_, std::ranges::greater{}, &Entry::time);
+            heap_.pop_back();
+        }
+    }
+
+    public:
+    Scheduler() { due_.fill(NEVER); }
+
+    /* Schedules the event at the given T-cycle, replacing the previously scheduled time of the event. */
+    void schedule(EVENT event, uint64_t time)
+    {
+        if (due_[std::to_underlying(event)] == time) return;
+
+        due_[std::to_underlying(event)] = time;
+        if (time == NEVER) return;
+
+        heap_.push_back({ time, event });
+        std::ranges::push_heap(heap_, std::ranges::greater{}, &Entry::time);
+    }
+
+    /* Returns the T-cycle the next event is due at. */
+    uint64_t next()
+    {
+        drop_stale();
+        return heap_.empty() ? NEVER : heap_.front().time;
+    }
+
+    /* Removes and returns the next event if it is due at or before the given T-cycle. */
+    std::optional<EVENT> pop(uint64_t until)
+    {
+        if (next() > until) return std::nullopt;
+
+        EVENT event = heap_.front().event;
+        std::ranges::pop_heap(heap_, std::ranges::greater{}, &Entry::time);
+        heap_.pop_back();
+        due_[std::to_underlying(event)] = NEVER;
+        return event;
+    }
+};
\ No newline at end of file
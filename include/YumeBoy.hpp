@@ -1,48 +1,237 @@
 #pragma once
 
+#include "apu/APU.hpp"
+#include "apu/NullAudioSink.hpp"
+#include "apu/RateControl.hpp"
 #include "cpu/CPU.hpp"
 #include "cpu/InterruptBus.hpp"
 #include "cartridge/Cartridge.hpp"
+#include "Diagnostics.hpp"
 #include "mmu/RAM.hpp"
-#include "mmu/MemoryStub.hpp"
 #include "mmu/MMU.hpp"
 #include "mmu/DMA.hpp"
+#include "mmu/SynchronizedMemory.hpp"
+#include "Scheduler.hpp"
 #include "ppu/LCD.hpp"
 #include "ppu/PPU.hpp"
+#include "ppu/HeadlessVideoSink.hpp"
+#include "serial/Serial.hpp"
+#include "serial/BufferSerialSink.hpp"
+#include "serial/CallbackSerialSink.hpp"
+#include "serial/FileSerialSink.hpp"
 #include "joypad/Joypad.hpp"
 #include "timer/Timer.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <istream>
 #include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
 #include "savestate/YumeBoySaveState.hpp"
 
 
 /** Stores all components of the emulator and facilitates communication between components. */
 class YumeBoy {
+    public:
+    /* Accurate: all components are ticked in lock-step every T-cycle.
+       Fast: the CPU runs whole instructions, the PPU, Timer and Serial port are only caught up in bulk when one of their
+       scheduled events is due (see `Scheduler`) or the CPU (or the DMA) accesses one of their registers. While the CPU
+       is halted, the emulation skips ahead to the next event. */
+    enum class ExecutionMode {
+        Accurate,
+        Fast,
+    };
+
+    /* Video: the frames are paced by the system clock at the nominal frame rate.
+       Audio: the frame rate is additionally corrected by a fraction of a percent to keep the buffer of the audio sink
+       filled (see `RateControl`), so the audio neither crackles nor lags behind as the system clock and the clock of the
+       audio device drift apart. */
+    enum class Pacing {
+        Video,
+        Audio,
+    };
+
+    private:
     uint64_t ticks = 0;
     std::string filepath;
 
+    ExecutionMode execution_mode_ = ExecutionMode::Accurate;
+    Pacing pacing_ = Pacing::Video;
+    RateControl rate_control_;
+    uint64_t synced_ticks = 0;  // the T-cycle up to which (including) the PPU, Timer and Serial port have been run
+    Scheduler scheduler_;
+    Diagnostics diagnostics_;
+
+    /* The longest instruction (CALL) takes 6 M-cycles. */
+    static constexpr uint64_t MAX_INSTRUCTION_T_CYCLES = 6 * 4;
+
     std::unique_ptr<MMU> mmu_;
     std::unique_ptr<CPU> cpu_;
     std::unique_ptr<Cartridge> cartridge_;
     std::unique_ptr<PPU> ppu_;
     std::unique_ptr<LCD> lcd_;
-    std::unique_ptr<MemorySTUB> audio_;
+    std::unique_ptr<APU> apu_;
     std::unique_ptr<RAM> hram_;
     std::unique_ptr<RAM> wram_;
-    std::unique_ptr<MemorySTUB> link_cable_;
+    std::unique_ptr<Serial> serial_;
     std::unique_ptr<Joypad> joypad_;
     std::unique_ptr<Timer> timer_;
     std::unique_ptr<InterruptBus> interrupts_;
     std::unique_ptr<DMA> dma_;
     std::unique_ptr<DMA_Memory> dma_memory_;
 
+    // the components with registers that are read or written in between two catch-ups in the fast execution mode, they
+    // are only mapped in the fast execution mode (see `map_synchronized`)
+    std::unique_ptr<SynchronizedMemory> synced_cpu_;
+    std::unique_ptr<SynchronizedMemory> synced_ppu_;
+    std::unique_ptr<SynchronizedMemory> synced_timer_;
+    std::unique_ptr<SynchronizedMemory> synced_serial_;
+
+    /* Runs the PPU, Timer and Serial port up to (and including) the given T-cycle. */
+    void catch_up(uint64_t until) {
+        if (synced_ticks >= until) return;
+        auto t_cycles = uint32_t(until - synced_ticks);
+        synced_ticks = until;
+        ppu_->tick(t_cycles);
+        timer_->tick(t_cycles);
+        serial_->tick(t_cycles);
+    }
+
+    /* Brings the PPU, Timer and Serial port to the state the CPU observes during the current T-cycle. */
+    void sync() {
+        if (synced_ticks + 1 < ticks)
+            catch_up(ticks - 1);
+    }
+
+    /* Determines when the given event is due next, based on the state of the components at `synced_ticks`. */
+    void schedule(Scheduler::EVENT event) {
+        std::optional<uint32_t> cycles;
+        switch (event) {
+            case Scheduler::EVENT::PPU:
+                cycles = ppu_->cycles_until_event();
+                break;
+            case Scheduler::EVENT::TIMER:
+                cycles = timer_->cycles_until_interrupt();
+                break;
+            case Scheduler::EVENT::SERIAL:
+                cycles = serial_->cycles_until_interrupt();
+                break;
+            case Scheduler::EVENT::AUDIO:
+                cycles = uint32_t(APU::BATCH_T_CYCLES - synced_ticks % APU::BATCH_T_CYCLES);
+                break;
+            case Scheduler::EVENT::DIAGNOSTICS:
+                cycles = uint32_t(Diagnostics::SUMMARY_T_CYCLES - synced_ticks % Diagnostics::SUMMARY_T_CYCLES);
+                break;
+            default:
+                std::unreachable();
+        }
+        scheduler_.schedule(event, cycles ? synced_ticks + *cycles : Scheduler::NEVER);
+    }
+
+    /* Catches up the PPU, Timer and Serial port if an event is due up to (and including) the given T-cycle and handles the due events. */
+    void handle_events(uint64_t until) {
+        if (scheduler_.next() > until) return;
+
+        catch_up(until);
+        while (auto event = scheduler_.pop(until)) {
+            if (*event == Scheduler::EVENT::AUDIO)
+                synthesize_audio();
+            else if (*event == Scheduler::EVENT::DIAGNOSTICS)
+                diagnostics_.summarize();
+            schedule(*event);
+        }
+    }
+
+    /* Runs the CPU (and DMA) until the current instruction is finished and handles the events that are due before the
+       next M-cycle of the CPU. If the CPU is halted afterwards, it skips ahead to the next event but not beyond `limit`. */
+    void step(uint64_t limit) {
+        assert(ticks % 4 == 0);
+        do {
+            ticks += 4;
+            cpu_->tick();
+            dma_->tick();
+        } while (cpu_->executing());
+        handle_events(ticks + 3);
+
+        if (cpu_->halted() and not dma_->active() and ticks < limit) {
+            // skip the M-cycles in which the CPU does nothing, the next event is observed by the following M-cycle
+            uint64_t next = scheduler_.next();
+            uint64_t skip = next > ticks + 3 ? (next - ticks) / 4 : 0;
+            ticks += 4 * std::min(skip, (limit - ticks) / 4);
+            handle_events(ticks + 3);
+        }
+    }
+
+    /* Synthesizes the next batch of samples. With audio pacing at real time, the fill level of the audio sink afterwards
+       corrects the frame rate. If the buffer is too full, e.g. since no frames are paced while the LCD is turned off,
+       the emulation waits for the audio device instead. If the device does not consume the samples within
+       `RateControl::MAX_WAIT`, e.g. since it stalled, the emulation falls back to video pacing. */
+    void synthesize_audio() {
+        apu_->synthesize();
+        if (pacing_ != Pacing::Audio or lcd_->speed() != 1) return;
+
+        auto fill = apu_->buffer_fill();
+        if (not fill) return;
+        lcd_->pacing_rate(rate_control_.update(*fill));
+
+        const auto deadline = std::chrono::steady_clock::now() + RateControl::MAX_WAIT;
+        for (; fill and *fill > RateControl::MAX_FILL; fill = apu_->buffer_fill()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                std::cerr << "The audio device stalled, falling back to video pacing\n";
+                pacing(Pacing::Video);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    /* Maps the PPU, Timer and Serial port (and IF/IE of the CPU) through a `SynchronizedMemory` or directly. The wrappers
+       are only needed in the fast execution mode, in lock-step the components are always in sync with the CPU. */
+    void map_synchronized(bool synchronized) {
+        const std::pair<Memory *, Memory *> components[] = {
+            { cpu_.get(), synced_cpu_.get() },
+            { ppu_.get(), synced_ppu_.get() },
+            { serial_.get(), synced_serial_.get() },
+            { timer_.get(), synced_timer_.get() },
+        };
+        for (auto [component, synced] : components) {
+            if (synchronized)
+                mmu_->replace(component, synced);
+            else
+                mmu_->replace(synced, component);
+        }
+    }
+
+    /* An access to a component may change when its next event is due, so the event is rescheduled after the instruction. */
+    void accessed(Scheduler::EVENT event) {
+        sync();
+        if (execution_mode_ == ExecutionMode::Fast)
+            scheduler_.schedule(event, synced_ticks);
+    }
+
     public:
-    explicit YumeBoy(std::string& filepath, bool skip_bootrom) : filepath(filepath) {
+    /* The completed frames are passed on to the given video sink, e.g. a `HeadlessVideoSink` to run without a window,
+       the synthesized samples to the given audio sink, e.g. a `NullAudioSink` to run without an audio device, and the
+       bytes sent over the serial port to the given serial sink, e.g. a `BufferSerialSink` to check the results of test
+       ROMs. Without a sink, the frames are not presented (the samples are not mixed, the bytes are dropped) at all.
+       The window and the audio device of the SDL front end are such sinks as well, the emulator itself does not depend on
+       SDL (see `YumeBoyCore`). */
+    explicit YumeBoy(const std::string &filepath, bool skip_bootrom,
+                     std::unique_ptr<VideoSink> video = nullptr,
+                     std::unique_ptr<AudioSink> audio = nullptr,
+                     std::unique_ptr<SerialSink> serial = nullptr)
+        : filepath(filepath) {
         mmu_ = std::make_unique<MMU>();
+        diagnostics_.add(mmu_->unmapped_accesses());
         dma_ = std::make_unique<DMA>(*mmu_);
         dma_memory_ = std::make_unique<DMA_Memory>(*mmu_, *dma_);
         mmu_->add(dma_.get());
 
         cpu_ = std::make_unique<CPU>(*dma_memory_, skip_bootrom);
+        synced_cpu_ = std::make_unique<SynchronizedMemory>(*cpu_, [this] { sync(); }); // IF and IE have no effect on events
         mmu_->add(cpu_.get());
 
         interrupts_ = std::make_unique<InterruptBus>(*cpu_);
@@ -50,12 +239,13 @@ class YumeBoy {
         cartridge_ = CartridgeFactory::Create(filepath, skip_bootrom);
         mmu_->add(cartridge_.get());
 
-        lcd_ = std::make_unique<LCD>("YumeBoy", LCD::DISPLAY_WIDTH * 4, LCD::DISPLAY_HEIGHT * 4);
+        lcd_ = std::make_unique<LCD>(std::move(video));
         ppu_ = std::make_unique<PPU>(*lcd_, *dma_memory_, *interrupts_);
+        synced_ppu_ = std::make_unique<SynchronizedMemory>(*ppu_, [this] { accessed(Scheduler::EVENT::PPU); });
         mmu_->add(ppu_.get());
 
-        audio_ = std::make_unique<MemorySTUB>("Audio", 0xFF10, 0xFF26);
-        mmu_->add(audio_.get());
+        apu_ = std::make_unique<APU>(ticks, std::move(audio));
+        mmu_->add(apu_.get());
 
         hram_ = std::make_unique<RAM>(0xFF80, 0xFFFE);
         mmu_->add(hram_.get());
@@ -63,20 +253,18 @@ class YumeBoy {
         wram_ = std::make_unique<RAM>(0xC000, 0xDFFF);
         mmu_->add(wram_.get());
 
-        link_cable_ = std::make_unique<MemorySTUB>("Serial Data Transfer (Link Cable)", 0xFF01, 0xFF02);
-        mmu_->add(link_cable_.get());
+        serial_ = std::make_unique<Serial>(synced_ticks, *interrupts_, std::move(serial));
+        synced_serial_ = std::make_unique<SynchronizedMemory>(*serial_, [this] { accessed(Scheduler::EVENT::SERIAL); });
+        mmu_->add(serial_.get());
 
-        joypad_ = std::make_unique<Joypad>(*this, *interrupts_);
+        joypad_ = std::make_unique<Joypad>(*interrupts_);
         mmu_->add(joypad_.get());
 
         timer_ = std::make_unique<Timer>(*interrupts_);
+        synced_timer_ = std::make_unique<SynchronizedMemory>(*timer_, [this] { accessed(Scheduler::EVENT::TIMER); });
         mmu_->add(timer_.get());
     }
 
-    ~YumeBoy() {
-        SDL_Quit();
-    }
-
     void tick() {
         ++ticks;
 
@@ -85,17 +273,106 @@ class YumeBoy {
             dma_->tick();
         }
 
-        if (ticks % 1000 == 0) { // SDL_PollEvent is expensive and updating the joypad state every tick is overkill
-            joypad_->update_joypad_state();
-        }
+        if (ticks % APU::BATCH_T_CYCLES == 0)
+            synthesize_audio();
 
+        if (ticks % Diagnostics::SUMMARY_T_CYCLES == 0)
+            diagnostics_.summarize();
+
+        synced_ticks = ticks;
         ppu_->tick();
         timer_->tick();
+        serial_->tick();
     }
 
-    YumeBoySaveState save_state() {
-        std::ofstream file("save_state.yb", std::ios::binary);
-        boost::archive::binary_oarchive oa(file);
+    /* Runs the emulation for the given number of T-cycles using the current execution mode. */
+    void run(uint64_t t_cycles) {
+        const uint64_t end = ticks + t_cycles;
+
+        if (execution_mode_ == ExecutionMode::Fast) {
+            while (ticks < end and ticks % 4 != 0)
+                tick();
+
+            // the scheduled events are outdated if the emulation ran in lock-step before
+            for (auto event : { Scheduler::EVENT::PPU, Scheduler::EVENT::TIMER, Scheduler::EVENT::SERIAL, Scheduler::EVENT::AUDIO, Scheduler::EVENT::DIAGNOSTICS })
+                schedule(event);
+
+            while (end - ticks > MAX_INSTRUCTION_T_CYCLES + 3)
+                step(end - MAX_INSTRUCTION_T_CYCLES - 4);
+
+            // continue in lock-step from the T-cycle before the next M-cycle of the CPU
+            handle_events(ticks + 3);
+            catch_up(ticks + 3);
+            ticks = synced_ticks;
+        }
+
+        while (ticks < end)
+            tick();
+    }
+
+    /* The number of T-cycles emulated so far. */
+    uint64_t t_cycles() const { return ticks; }
+
+    /* Plugs one end of a link cable into the serial port, unplugs the cable if null. Linked Game Boys are run by
+       `LinkCable`, which also has to receive the bytes sent over the cable in between runs (see `poll_link`). */
+    void connect(LinkPort *port) { serial_->connect(port); }
+    void poll_link() { serial_->poll_link(); }
+
+    /* Sets the buttons that are held down, the front end polls its input in between runs. */
+    void buttons(const Joypad::Buttons &buttons) { joypad_->buttons(buttons); }
+
+    ExecutionMode execution_mode() const { return execution_mode_; }
+    void execution_mode(ExecutionMode mode) {
+        if (mode == execution_mode_) return;
+        execution_mode_ = mode;
+        map_synchronized(mode == ExecutionMode::Fast);
+    }
+
+    /* The speed of the emulation relative to a real Game Boy, e.g. 1 for real time or 4 to fast-forward.
+       A speed of 0 runs the emulation as fast as possible. */
+    double speed() const { return lcd_->speed(); }
+    void speed(double speed) { lcd_->speed(speed); }
+
+    Pacing pacing() const { return pacing_; }
+    void pacing(Pacing pacing) {
+        pacing_ = pacing;
+        if (pacing == Pacing::Video)
+            lcd_->pacing_rate(1);
+    }
+
+    /* How late the emulation woke up after the frames were due and how the pacing was corrected to keep the buffer of the
+       audio sink filled. */
+    const FramePacer::Jitter &frame_jitter() const { return lcd_->frame_jitter(); }
+    const RateControl::Statistics &rate_control() const { return rate_control_.statistics(); }
+
+    /* The number of frames that are emulated but not presented after each presented frame, e.g. 3 to present only
+       every 4th frame. */
+    uint8_t frame_skip() const { return lcd_->frame_skip(); }
+    void frame_skip(uint8_t frames) { lcd_->frame_skip(frames); }
+
+    /* How the PPU composes the scanlines, both renderers produce the same frames (see `PPU::Renderer`). */
+    PPU::Renderer renderer() const { return ppu_->renderer(); }
+    void renderer(PPU::Renderer renderer) { ppu_->renderer(renderer); }
+
+    /* How many of the presented frames were unchanged, partially or fully changed compared to their previous frame. */
+    const LCD::FrameCounters &frame_counters() const { return lcd_->frame_counters(); }
+
+    /* The counters of accesses to unmapped addresses, which are summarized every 10 seconds of emulated time. */
+    Diagnostics &diagnostics() { return diagnostics_; }
+
+    /* How often the audio sink ran out of samples (underruns) or had to drop samples (overruns). */
+    AudioSink::Counters audio_counters() const { return apu_->audio_counters(); }
+
+    /* Changes the colors (packed with `LCD::rgba`) the four shades of gray are displayed with. */
+    void color_scheme(const std::array<uint32_t, 4> &colors) {
+        lcd_->color_scheme(colors);
+        ppu_->update_palettes();
+    }
+
+    /* Writes the state to the given binary stream, e.g. a file or memory (see `YumeBoyCore::save_state`). */
+    YumeBoySaveState save_state(std::ostream &out) {
+        sync();
+        boost::archive::binary_oarchive oa(out);
         YumeBoySaveState s = {
             ticks,
             filepath,
@@ -104,10 +381,10 @@ class YumeBoy {
             cartridge_->save_state(),
             ppu_->save_state(),
             lcd_->save_state(),
-            audio_->save_state(),
+            apu_->save_state(),
             hram_->save_state(),
             wram_->save_state(),
-            link_cable_->save_state(),
+            serial_->save_state(),
             joypad_->save_state(),
             timer_->save_state(),
             dma_->save_state(),
@@ -116,29 +393,42 @@ class YumeBoy {
         return s;
     }
 
-    void load_state() {
-        std::ifstream file("save_state.yb", std::ios::binary);
-        boost::archive::binary_iarchive ia(file);
-        if (not file.is_open()) return;
+    YumeBoySaveState save_state(const std::string &path = "save_state.yb") {
+        std::ofstream file(path, std::ios::binary);
+        return save_state(file);
+    }
+
+    /* Returns false if the state was saved with another ROM. */
+    bool load_state(std::istream &in) {
+        boost::archive::binary_iarchive ia(in);
 
         YumeBoySaveState savestate;
         ia >> savestate;
 
-        if (filepath.compare(savestate.filepath) != 0) return;
+        if (filepath.compare(savestate.filepath) != 0) return false;
 
         ticks = savestate.ticks;
+        synced_ticks = ticks;
 
         cpu_->load_state(savestate.cpu_);
         cartridge_->load_state(savestate.cartridge_);
-        ppu_->load_state(savestate.ppu_);
         lcd_->load_state(savestate.lcd_);
-        audio_->load_state(savestate.audio_);
+        ppu_->load_state(savestate.ppu_);
+        apu_->load_state(savestate.apu_);
         hram_->load_state(savestate.hram_);
         wram_->load_state(savestate.wram_);
-        link_cable_->load_state(savestate.link_cable_);
+        serial_->load_state(savestate.serial_);
         joypad_->load_state(savestate.joypad_);
         timer_->load_state(savestate.timer_);
         dma_->load_state(savestate.dma_);
+        return true;
+    }
+
+    /* Returns false if there is no save state at the given path or it was saved with another ROM. */
+    bool load_state(const std::string &path = "save_state.yb") {
+        std::ifstream file(path, std::ios::binary);
+        if (not file.is_open()) return false;
+        return load_state(file);
     }
 
 #ifndef NDEBUG
@@ -186,8 +476,9 @@ class YumeBoy {
                 uint8_t higher_byte = mmu_->read_memory(tile_data_addr + (tile_row * 2) + 1);
 
                 // convert to color using palette
+                TileCache::Row tile_colors = TileCache::decode(lower_byte, higher_byte);
                 for (int i = 7; i >= 0; --i) {
-                    uint8_t tile_color = (((higher_byte << 1) >> i) & 0b10) | ((lower_byte >> i) & 0b1);
+                    uint8_t tile_color = tile_colors[7 - i];
                     uint8_t c = (palette >> (2 * tile_color)) & 0b11;
                     uint8_t r, g, b;
 
@@ -241,10 +532,6 @@ class YumeBoy {
 
         tilemap_file.close();
     }
-
-    void screenshot() const {
-        lcd_->screenshot("screenshot.bpm");
-    }
 #endif
 
 };
\ No newline at end of file
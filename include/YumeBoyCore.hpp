@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "YumeBoy.hpp"
+
+
+/** The API of the `yumeboy_core` library, which has no dependency on SDL, e.g. to embed the emulator into other front
+ * ends or to run it in batch jobs. The sinks are handed over once and are kept when another ROM is loaded. Every
+ * presented frame is kept in memory as well (see `framebuffer`). Everything beyond this API is reached through
+ * `yume_boy`, which is replaced by every ROM that is loaded. */
+class YumeBoyCore {
+    public:
+    using Buttons = Joypad::Buttons;
+    using Frame = VideoSink::Frame;
+
+    private:
+    /* Keeps a copy of the presented frames and passes them on to the video sink of the client, if there is one. */
+    class FramebufferSink : public VideoSink {
+        Frame &framebuffer_;
+        VideoSink *client_;
+
+        public:
+        FramebufferSink(Frame &framebuffer, VideoSink *client) : framebuffer_(framebuffer), client_(client) { }
+
+        void present(const Frame &frame, const DirtyLines &dirty_lines) override
+        {
+            constexpr size_t LINE = WIDTH * 4;
+            for (size_t y = 0; y < HEIGHT; ++y)
+                if (dirty_lines[y])
+                    std::copy_n(frame.begin() + y * LINE, LINE, framebuffer_.begin() + y * LINE);
+            if (client_)
+                client_->present(frame, dirty_lines);
+        }
+    };
+
+    /* Passes the samples on to the audio sink of the client. */
+    class ForwardingAudioSink : public AudioSink {
+        AudioSink &client_;
+
+        public:
+        explicit ForwardingAudioSink(AudioSink &client) : client_(client) { }
+
+        void push(std::span<const int16_t> samples) override { client_.push(samples); }
+        Counters counters() const override { return client_.counters(); }
+        std::optional<double> buffer_fill() const override { return client_.buffer_fill(); }
+    };
+
+    /* Passes the bytes on to the serial sink of the client. */
+    class ForwardingSerialSink : public SerialSink {
+        SerialSink &client_;
+
+        public:
+        explicit ForwardingSerialSink(SerialSink &client) : client_(client) { }
+
+        void receive(uint8_t byte) override { client_.receive(byte); }
+    };
+
+    std::unique_ptr<VideoSink> video_;
+    std::unique_ptr<AudioSink> audio_;
+    std::unique_ptr<SerialSink> serial_;
+    Frame framebuffer_{};
+    std::unique_ptr<YumeBoy> yume_boy_;    // destroyed before the sinks it passes the output on to
+
+    public:
+    /* The sinks are optional: without an audio sink the samples are not mixed, without a serial sink the bytes are
+       dropped. The frames are always kept for `framebuffer`. */
+    explicit YumeBoyCore(std::unique_ptr<VideoSink> video = nullptr, std::unique_ptr<AudioSink> audio = nullptr,
+                         std::unique_ptr<SerialSink> serial = nullptr)
+        : video_(std::move(video)), audio_(std::move(audio)), serial_(std::move(serial)) { }
+
+    YumeBoyCore(const YumeBoyCore &) = delete;
+    YumeBoyCore &operator=(const YumeBoyCore &) = delete;
+
+    /* Powers on a Game Boy with the given ROM, which replaces the previous one. The execution mode, speed, pacing,
+       frame skip and renderer carry over. Throws if the ROM cannot be loaded, the previous one keeps running then. */
+    void load_rom(const std::string &path, bool skip_bootrom = false)
+    {
+        auto yume_boy = std::make_unique<YumeBoy>(
+            path, skip_bootrom, std::make_unique<FramebufferSink>(framebuffer_, video_.get()),
+            audio_ ? std::make_unique<ForwardingAudioSink>(*audio_) : nullptr,
+            serial_ ? std::make_unique<ForwardingSerialSink>(*serial_) : nullptr);
+        if (yume_boy_) {
+            yume_boy->execution_mode(yume_boy_->execution_mode());
+            yume_boy->speed(yume_boy_->speed());
+            yume_boy->pacing(yume_boy_->pacing());
+            yume_boy->frame_skip(yume_boy_->frame_skip());
+            yume_boy->renderer(yume_boy_->renderer());
+        }
+        yume_boy_ = std::move(yume_boy);
+        framebuffer_.fill(0);
+    }
+
+    bool loaded() const { return yume_boy_ != nullptr; }
+
+    /* Runs the emulation for the duration of a frame, so exactly one frame completes while the LCD is on. */
+    void run_frame() { yume_boy().run(LCD::FRAME_T_CYCLES); }
+
+    /* Runs the emulation for the given number of T-cycles. */
+    void run(uint64_t t_cycles) { yume_boy().run(t_cycles); }
+
+    /* The number of T-cycles emulated so far, including those before a loaded state was saved. */
+    uint64_t t_cycles() const { return yume_boy().t_cycles(); }
+
+    /* The most recently presented frame (see `VideoSink::Frame`), all zeros until the first frame of the ROM. Frames that
+       are skipped (see `YumeBoy::frame_skip`) are not presented. */
+    const Frame &framebuffer() const { return framebuffer_; }
+
+    /* Sets the buttons that are held down until the next call. */
+    void set_input(const Buttons &buttons) { yume_boy().buttons(buttons); }
+
+    /* The state in the same format as the save state files (see `YumeBoy::save_state`). */
+    std::vector<uint8_t> save_state()
+    {
+        std::ostringstream out(std::ios::binary);
+        yume_boy().save_state(out);
+        auto bytes = std::move(out).str();
+        return { bytes.begin(), bytes.end() };
+    }
+
+    /* Returns false if the state was saved with another ROM, throws if it is not a save state at all. */
+    bool load_state(std::span<const uint8_t> state)
+    {
+        std::istringstream in(std::string(state.begin(), state.end()), std::ios::binary);
+        return yume_boy().load_state(in);
+    }
+
+    /* The emulator of the loaded ROM. Throws if no ROM is loaded. */
+    YumeBoy &yume_boy()
+    {
+        if (not yume_boy_)
+            throw std::logic_error("No ROM is loaded");
+        return *yume_boy_;
+    }
+
+    const YumeBoy &yume_boy() const
+    {
+        if (not yume_boy_)
+            throw std::logic_error("No ROM is loaded");
+        return *yume_boy_;
+    }
+};
\ No newline at end of file
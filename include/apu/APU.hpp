@@ -3,80 +3,168 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <vector>
+#include "apu/AudioSink.hpp"
+#include "mmu/Memory.hpp"
 
-class YumeBoy;
+struct APUSaveState;
 
-class APU {
-    YumeBoy &yume_boy_; // Reference to Emulator
-    uint32_t time_;     // the amount of time the apu has been running for (in T-cycles / 2^22 Hz)
+/** The Audio Processing Unit. It is not ticked with the rest of the emulator: register writes are recorded with the
+ * T-cycle they happen at and the four channels are synthesized in batches (see `synthesize`), which applies the recorded
+ * writes at their T-cycles. The samples of each batch are passed on to an `AudioSink`. */
+class APU : public Memory {
+    public:
+    static constexpr uint32_t CLOCK_RATE = 1 << 22;             // T-cycles per second
+    static constexpr uint32_t SAMPLE_RATE = AudioSink::SAMPLE_RATE;
+    static constexpr uint32_t BATCH_T_CYCLES = 1 << 14;         // the emulator synthesizes a batch every ~4ms
+    static constexpr uint32_t FRAME_SEQUENCER_T_CYCLES = 8192;  // the frame sequencer is clocked at 512 Hz
+
+    private:
+    const uint64_t &clock_; // the current T-cycle of the emulator
+    uint64_t time_ = 0;     // the T-cycle up to which the channels have been synthesized
 
     /* Registers
        From https://gbdev.io/pandocs/Audio_Registers.html:
-       Audio registers are named following a NRxy scheme, where x is the channel number (or 5 for “global” registers), and y is the register’s ID within the channel. Since many registers share common properties, a notation is often used where e.g. NRx2 is used to designate NR12, NR22, NR32, and NR42 at the same time, for simplicity. */
-
-    /* Sound Channel 1 — Pulse with period sweep */
-    /* 0xFF10 — NR10: Channel 1 sweep */
-    uint8_t NR10 = 0x0;
-    /* 0xFF11 — NR11: Channel 1 length timer & duty cycle */
-    uint8_t NR11 = 0x0;
-    /* 0xFF12 — NR12: Channel 1 volume & envelope */
-    uint8_t NR12 = 0x0;
-    /* 0xFF13 — NR13: Channel 1 period low [write-only] */
-    uint8_t NR13 = 0x0;
-    /* 0xFF14 — NR14: Channel 1 period high & control */
-    uint8_t NR14 = 0x0;
-
-    /* Sound Channel 2 — Pulse */
-    /* 0xFF16 — NR21: Channel 2 length timer & duty cycle */
-    uint8_t NR21 = 0x0;
-    /* 0xFF17 — NR22: Channel 2 volume & envelope */
-    uint8_t NR22 = 0x0;
-    /* 0xFF18 — NR23: Channel 2 period low [write-only] */
-    uint8_t NR23 = 0x0;
-    /* 0xFF19 — NR24: Channel 2 period high & control */
-    uint8_t NR24 = 0x0;
-
-    /* Sound Channel 3 — Wave output */
-    /* 0xFF1A — NR30: Channel 3 DAC enable */
-    uint8_t NR30 = 0x0;
-    /* 0xFF1B — NR31: Channel 3 length timer [write-only] */
-    uint8_t NR31 = 0x0;
-    /* 0xFF1C — NR32: Channel 3 output level */
-    uint8_t NR32 = 0x0;
-    /* 0xFF1D — NR33: Channel 3 period low [write-only] */
-    uint8_t NR33 = 0x0;
-    /* 0xFF1E — NR34: Channel 3 period high & control */
-    uint8_t NR34 = 0x0;
-
-    /* 0xFF30–0xFF3F — Wave pattern RAM
+       Audio registers are named following a NRxy scheme, where x is the channel number (or 5 for “global” registers), and y is the register’s ID within the channel. Since many registers share common properties, a notation is often used where e.g. NRx2 is used to designate NR12, NR22, NR32, and NR42 at the same time, for simplicity.
 
-       Wave RAM is 16 bytes long; each byte holds two “samples”, each 4 bits.
+       Sound Channel 1 — Pulse with period sweep
+       0xFF10 — NR10: Channel 1 sweep
+       0xFF11 — NR11: Channel 1 length timer & duty cycle
+       0xFF12 — NR12: Channel 1 volume & envelope
+       0xFF13 — NR13: Channel 1 period low [write-only]
+       0xFF14 — NR14: Channel 1 period high & control
+
+       Sound Channel 2 — Pulse
+       0xFF16 — NR21: Channel 2 length timer & duty cycle
+       0xFF17 — NR22: Channel 2 volume & envelope
+       0xFF18 — NR23: Channel 2 period low [write-only]
+       0xFF19 — NR24: Channel 2 period high & control
+
+       Sound Channel 3 — Wave output
+       0xFF1A — NR30: Channel 3 DAC enable
+       0xFF1B — NR31: Channel 3 length timer [write-only]
+       0xFF1C — NR32: Channel 3 output level
+       0xFF1D — NR33: Channel 3 period low [write-only]
+       0xFF1E — NR34: Channel 3 period high & control
+
+       Sound Channel 4 — Noise
+       0xFF20 — NR41: Channel 4 length timer [write-only]
+       0xFF21 — NR42: Channel 4 volume & envelope
+       0xFF22 — NR43: Channel 4 frequency & randomness
+       0xFF23 — NR44: Channel 4 control
+
+       Global control registers
+       0xFF24 — NR50: Master volume & VIN panning
+       0xFF25 — NR51: Sound panning
+       0xFF26 — NR52: Audio master control
 
+       0xFF30–0xFF3F — Wave pattern RAM
+       Wave RAM is 16 bytes long; each byte holds two “samples”, each 4 bits.
        As CH3 plays, it reads wave RAM left to right, upper nibble first. That is, $FF30’s upper nibble, $FF30’s lower nibble, $FF31’s upper nibble, and so on. */
-    std::array<uint8_t, 16> wave_pattern_ram;
-
-    /* Sound Channel 4 — Noise */
-    /* 0xFF20 — NR41: Channel 4 length timer [write-only] */
-    uint8_t NR41 = 0x0;
-    /* 0xFF21 — NR42: Channel 4 volume & envelope */
-    uint8_t NR42 = 0x0;
-    /* 0xFF22 — NR43: Channel 4 frequency & randomness */
-    uint8_t NR43 = 0x0;
-    /* 0xFF23 — NR44: Channel 4 control */
-    uint8_t NR44 = 0x0;
-
-    /* Global control registers */
-    /* 0xFF24 — NR50: Master volume & VIN panning */
-    uint8_t NR50 = 0x0;
-    /* 0xFF25 — NR51: Sound panning */
-    uint8_t NR51 = 0x0;
-    /* 0xFF26 — NR52: Audio master control */
-    uint8_t NR52 = 0x0;
+    static constexpr uint16_t REG_BEGIN = 0xFF10;
+    static constexpr uint16_t REG_END = 0xFF3F;
+    enum Register : uint16_t {
+        NR10 = 0xFF10, NR11, NR12, NR13, NR14,
+        NR21 = 0xFF16, NR22, NR23, NR24,
+        NR30 = 0xFF1A, NR31, NR32, NR33, NR34,
+        NR41 = 0xFF20, NR42, NR43, NR44,
+        NR50 = 0xFF24, NR51, NR52,
+        WAVE_RAM = 0xFF30,
+    };
+
+    /* The registers as the CPU has written them, including the writes that have not been synthesized yet. */
+    std::array<uint8_t, REG_END - REG_BEGIN + 1> registers_{};
+    /* The registers as of `time_`, which the channels are synthesized from. */
+    std::array<uint8_t, REG_END - REG_BEGIN + 1> applied_{};
+
+    uint8_t &reg(uint16_t addr) { return applied_[addr - REG_BEGIN]; }
+    uint8_t reg(uint16_t addr) const { return applied_[addr - REG_BEGIN]; }
+
+    /* A register write that has not been synthesized yet. */
+    struct Write {
+        uint64_t time;
+        uint16_t addr;
+        uint8_t value;
+    };
+    std::vector<Write> pending_writes;
+
+    /* Applies a register write to `applied_` and the channels. */
+    void apply(uint16_t addr, uint8_t value);
+
+    public:
+    /* The internal state of a channel. Not every channel uses every member. */
+    struct Channel {
+        bool enabled = false;
+        bool length_enabled = false;
+        uint16_t length = 0;            // the length timer counts up to 64 (256 for the wave channel)
+        uint8_t volume = 0;
+        uint8_t envelope_timer = 0;
+        int32_t timer = 0;              // T-cycles until the next step of the waveform
+        uint8_t step = 0;               // the position in the duty cycle or wave RAM
+        uint16_t lfsr = 0;              // noise channel
+        bool sweep_enabled = false;     // channel 1 only
+        uint16_t shadow_period = 0;     // channel 1 only
+        uint8_t sweep_timer = 0;        // channel 1 only
+    };
+
+    private:
+    std::array<Channel, 4> channels;
+    uint8_t frame_sequencer_step = 0;
+
+    /* The period registers of channels 1-3 (11 bit) and the T-cycles of a step of their waveform. */
+    uint16_t period(uint8_t channel) const;
+    int32_t step_t_cycles(uint8_t channel) const;
+
+    void trigger(uint8_t channel);
+    void clock_length(Channel &ch);
+    void clock_envelope(Channel &ch, uint8_t NRx2);
+    void clock_sweep();
+    /* Returns the next period of the sweep, disables channel 1 if it overflows. */
+    uint16_t sweep_period();
+    void clock_frame_sequencer();
+
+    /* Advances the waveforms of all channels by the given number of T-cycles. */
+    void advance(uint32_t t_cycles);
+
+    /* The current output of a channel (0-15), nothing if its DAC is turned off. */
+    int output(uint8_t channel) const;
+
+    /* Output */
+    uint64_t next_sample = 0;       // the T-cycle at which the next sample is taken
+    uint32_t sample_remainder = 0;  // the fraction of a T-cycle (in 1/SAMPLE_RATE) by which `next_sample` is late
+    std::array<float, 2> high_pass_charge{};    // removes the DC offset like the capacitors of the Game Boy
+    std::vector<int16_t> samples_;  // interleaved stereo samples (left, right) that have not been passed on to the sink yet
+    std::unique_ptr<AudioSink> sink;
+
+    void mix();
 
     public:
     APU() = delete;
-    explicit APU(YumeBoy &yume_boy) : yume_boy_(yume_boy) { }
+    /* Without a sink, the samples are not mixed at all. */
+    APU(const uint64_t &clock, std::unique_ptr<AudioSink> sink) : clock_(clock), sink(std::move(sink)) { }
+
+    bool contains_address(uint16_t addr) const override {
+        return REG_BEGIN <= addr and addr <= REG_END;
+    }
+
+    uint8_t read_memory(uint16_t addr) override;
+    void write_memory(uint16_t addr, uint8_t value) override;
+
+    /* Synthesizes the channels up to the current T-cycle of the emulator and passes the samples on to the sink. */
+    void synthesize() { synthesize(clock_); }
+    void synthesize(uint64_t until);
+
+    /* How often the sink ran out of samples or had to drop them. */
+    AudioSink::Counters audio_counters() const {
+        return sink ? sink->counters() : AudioSink::Counters{};
+    }
+
+    /* How full the buffer of the sink is (0-1), nothing if there is no sink or it does not buffer samples. */
+    std::optional<double> buffer_fill() const {
+        return sink ? sink->buffer_fill() : std::nullopt;
+    }
 
-    /* Runs the APU until it reaches the next "stable" state. Returns the amount of time spent. */
-    uint32_t tick();
+    APUSaveState save_state();
+    void load_state(APUSaveState state);
 };
\ No newline at end of file
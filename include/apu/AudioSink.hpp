@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+
+/** Receives the samples synthesized by the `APU`, e.g. to play them on an audio device. */
+class AudioSink {
+    public:
+    static constexpr uint32_t SAMPLE_RATE = 48000;  // stereo samples per second
+
+    /* How often the sink ran out of samples (underruns) and how often it had to drop samples because it was full
+       (overruns). */
+    struct Counters {
+        uint64_t underruns = 0;
+        uint64_t overruns = 0;
+    };
+
+    virtual ~AudioSink() = default;
+
+    /* Called on the emulation thread after every batch of synthesized samples, the samples are interleaved stereo (left,
+       right) and only valid during the call. */
+    virtual void push(std::span<const int16_t> samples) = 0;
+
+    virtual Counters counters() const { return {}; }
+
+    /* How full the buffer of the sink is (0-1), nothing if the sink does not buffer samples. */
+    virtual std::optional<double> buffer_fill() const { return std::nullopt; }
+};
\ No newline at end of file
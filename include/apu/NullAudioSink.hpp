@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include "apu/AudioSink.hpp"
+
+
+/** Discards the samples instead of playing them, e.g. for batch runs without an audio device. */
+class NullAudioSink : public AudioSink {
+    uint64_t sample_count_ = 0;
+
+    public:
+    void push(std::span<const int16_t> samples) override
+    {
+        sample_count_ += samples.size() / 2;
+    }
+
+    /* The number of stereo samples synthesized so far. */
+    uint64_t sample_count() const { return sample_count_; }
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+
+/** Dynamic rate control: the emulation produces samples by the system clock while the audio device consumes them by its
+ * own clock, and the two drift apart. Instead of letting the buffer of the audio sink run dry or overflow now and then,
+ * the emulation runs slightly faster while the buffer is less than `TARGET_FILL` full and slightly slower while it is
+ * fuller. The rate deviates by at most `MAX_DEVIATION`, which is neither audible nor visible. */
+class RateControl {
+    public:
+    static constexpr double MAX_DEVIATION = 0.005;
+    static constexpr double TARGET_FILL = 0.25;
+    /* The emulation waits for the audio device while the buffer is fuller, the rate alone would take too long to
+       empty it. */
+    static constexpr double MAX_FILL = 2 * TARGET_FILL;
+    /* The longest the emulation waits for the audio device at a time, about the length of the buffer of the sink. If the
+       buffer does not empty in that time, the device does not consume samples (anymore). */
+    static constexpr std::chrono::milliseconds MAX_WAIT{ 200 };
+    /* The weight of a new fill level in the smoothed fill level. The fill level measured after a batch jumps with every
+       chunk the audio device takes, the rate should not. */
+    static constexpr double SMOOTHING = 0.05;
+
+    struct Statistics {
+        double rate = 1;                // the most recent rate
+        double fill = TARGET_FILL;      // the smoothed fill level the rate is derived from
+        double min_fill = 1;            // the lowest and highest fill levels measured
+        double max_fill = 0;
+        uint64_t updates = 0;
+    };
+
+    private:
+    Statistics statistics_;
+
+    public:
+    /* Returns the rate for the given fill level of the buffer (0-1), measured after a batch of samples was pushed. */
+    double update(double fill)
+    {
+        statistics_.fill += (fill - statistics_.fill) * SMOOTHING;
+        statistics_.min_fill = std::min(statistics_.min_fill, fill);
+        statistics_.max_fill = std::max(statistics_.max_fill, fill);
+        ++statistics_.updates;
+
+        double error = std::clamp((TARGET_FILL - statistics_.fill) / TARGET_FILL, -1.0, 1.0);
+        statistics_.rate = 1 + error * MAX_DEVIATION;
+        return statistics_.rate;
+    }
+
+    const Statistics &statistics() const { return statistics_; }
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <span>
+
+
+/** Hands over a stream of values (e.g. audio samples) from a producer thread to a consumer thread without locks. Values
+ * that do not fit are not written, the producer decides what to do with them. Exactly one thread may write and exactly one
+ * thread may read. */
+template <typename T, size_t CAPACITY>
+class RingBuffer {
+    static_assert(std::has_single_bit(CAPACITY), "the capacity has to be a power of two");
+
+    std::array<T, CAPACITY> buffer_{};
+    /* Both positions only ever increase and are wrapped when the buffer is accessed. They are kept on separate cache lines
+       since each of them is written by another thread. */
+    alignas(64) std::atomic<size_t> read_ = 0;     // only written by the consumer
+    alignas(64) std::atomic<size_t> write_ = 0;    // only written by the producer
+
+    public:
+    static constexpr size_t capacity() { return CAPACITY; }
+
+    /* The number of values that have been written but not read yet. Only exact on the producer or consumer thread, the
+       other side may change it at any time. */
+    size_t size() const
+    {
+        return write_.load(std::memory_order_acquire) - read_.load(std::memory_order_acquire);
+    }
+
+    /* Producer: appends as many of the given values as fit and returns how many were written. */
+    size_t write(std::span<const T> values)
+    {
+        size_t write = write_.load(std::memory_order_relaxed);
+        size_t count = std::min(values.size(), CAPACITY - (write - read_.load(std::memory_order_acquire)));
+
+        size_t offset = write % CAPACITY;
+        size_t first = std::min(count, CAPACITY - offset);
+        std::copy_n(values.begin(), first, buffer_.begin() + offset);
+        std::copy_n(values.begin() + first, count - first, buffer_.begin());
+
+        write_.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    /* Consumer: moves up to `out.size()` of the oldest values into `out` and returns how many were moved. */
+    size_t read(std::span<T> out)
+    {
+        size_t read = read_.load(std::memory_order_relaxed);
+        size_t count = std::min(out.size(), write_.load(std::memory_order_acquire) - read);
+
+        size_t offset = read % CAPACITY;
+        size_t first = std::min(count, CAPACITY - offset);
+        std::copy_n(buffer_.begin() + offset, first, out.begin());
+        std::copy_n(buffer_.begin(), count - first, out.begin() + first);
+
+        read_.store(read + count, std::memory_order_release);
+        return count;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <SDL3/SDL.h>
+#include "apu/AudioSink.hpp"
+#include "apu/RingBuffer.hpp"
+
+
+/** Plays the samples on the default audio device. The samples are handed over to the audio callback of an SDL audio
+ * stream through a lock-free ring buffer, so the emulation never waits for the audio device (and vice versa). */
+class SDLAudioSink : public AudioSink {
+    struct sdl_deleter
+    {
+        void operator()(SDL_AudioStream *p) const { SDL_DestroyAudioStream(p); }
+    };
+
+    /* ~170ms of interleaved stereo samples. Samples are only ever written and read in whole stereo samples. */
+    RingBuffer<int16_t, 1 << 14> buffered_samples;
+    /* The device is only started once this many samples have been buffered, so it does not run dry right away. */
+    static constexpr size_t START_SAMPLES = 2 * SAMPLE_RATE / 25;   // 40ms
+    bool started = false;
+
+    std::atomic<uint64_t> underruns = 0;    // written by the audio callback
+    uint64_t overruns = 0;                  // written by the emulation thread
+
+    std::unique_ptr<SDL_AudioStream, sdl_deleter> stream;
+
+    /* The audio callback, runs on SDL's audio thread whenever the device needs more samples. */
+    static void feed(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount);
+
+    public:
+    SDLAudioSink();
+    ~SDLAudioSink() override;
+
+    void push(std::span<const int16_t> samples) override;
+    Counters counters() const override;
+    std::optional<double> buffer_fill() const override;
+};
\ No newline at end of file
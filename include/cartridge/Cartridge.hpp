@@ -6,6 +6,7 @@
 #include <fstream>
 #include <memory>
 #include "mmu/Memory.hpp"
+#include "mmu/MMU.hpp"
 #include <savestate/CartridgeSaveState.hpp>
 
 /** Represents the read-only memory_ of game cartridges */
@@ -22,17 +23,23 @@ protected:
     const uint8_t RAM_SIZE;
 
     uint8_t rom_bytes(uint32_t addr);
+    const uint8_t *rom_ptr(uint32_t addr) const;
     uint8_t ram_bytes(uint32_t addr);
     void ram_bytes(uint32_t addr, uint8_t value);
 
     virtual uint8_t read_rom(uint16_t addr) = 0;
+    /* Returns a pointer to the ROM byte mapped to the given address if reading it can bypass `read_rom`, nullptr otherwise (e.g. for switchable banks). */
+    virtual const uint8_t *read_rom_ptr(uint16_t addr [[maybe_unused]]) { return nullptr; }
     virtual void write_rom(uint16_t addr [[maybe_unused]], uint8_t value [[maybe_unused]]) { /* Writing to ROM is not possible by default. */ };
 
     virtual uint8_t read_ram(uint16_t addr) = 0;
     virtual void write_ram(uint16_t addr, uint8_t value) = 0;
 
     uint8_t boot_rom_enabled() const { return boot_rom_enabled_; }
-    void boot_rom_enabled(uint8_t value) { boot_rom_enabled_ = value; }
+    void boot_rom_enabled(uint8_t value) {
+        boot_rom_enabled_ = value;
+        remap();    // the boot ROM overlays the first 256 bytes of the ROM
+    }
 
 public:
     Cartridge(std::vector<uint8_t> rom_bytes, std::vector<uint8_t> ram_bytes, uint8_t carrtidge_type, uint8_t rom_size, uint8_t ram_size) : rom_bytes_(std::move(rom_bytes)), ram_bytes_(std::move(ram_bytes)), CARTRIDGE_TYPE(carrtidge_type), ROM_SIZE(rom_size), RAM_SIZE(ram_size) {}
@@ -63,6 +70,12 @@ public:
             std::unreachable();
     }
 
+    const uint8_t *read_ptr(uint16_t addr) override {
+        if (addr <= 0x7FFF)
+            return read_rom_ptr(addr);
+        return nullptr;
+    }
+
     virtual CartridgeSaveState save_state();
 
     virtual void load_state(CartridgeSaveState state);
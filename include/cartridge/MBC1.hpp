@@ -30,11 +30,7 @@ class MBC1 : public Cartridge
         return phy_addr;
     };
 
-public:
-    MBC1(std::vector<uint8_t> rom_bytes, std::vector<uint8_t> ram_bytes, uint8_t carrtidge_type, uint8_t rom_size, uint8_t ram_size) : Cartridge(std::move(rom_bytes), std::move(ram_bytes), carrtidge_type, rom_size, ram_size) {};
-    MBC1(std::vector<uint8_t> rom_bytes, uint8_t carrtidge_type, uint8_t rom_size) : Cartridge(std::move(rom_bytes), {}, carrtidge_type, rom_size, 0x00) {};
-
-    uint8_t read_rom(uint16_t addr) override
+    uint32_t translate_rom_addr(uint16_t addr) const
     {
         // TODO: https://gbdev.io/pandocs/MBC1.html#mbc1m-1-mib-multi-game-compilation-carts
         assert(addr < 0xA000);
@@ -51,7 +47,23 @@ public:
         // only consider the relevant bits and ignore upper bits (TODO: could be done using constexprs)
         phy_addr %= 1 << (15 + ROM_SIZE);
 
-        return Cartridge::rom_bytes(phy_addr);
+        return phy_addr;
+    };
+
+public:
+    MBC1(std::vector<uint8_t> rom_bytes, std::vector<uint8_t> ram_bytes, uint8_t carrtidge_type, uint8_t rom_size, uint8_t ram_size) : Cartridge(std::move(rom_bytes), std::move(ram_bytes), carrtidge_type, rom_size, ram_size) {};
+    MBC1(std::vector<uint8_t> rom_bytes, uint8_t carrtidge_type, uint8_t rom_size) : Cartridge(std::move(rom_bytes), {}, carrtidge_type, rom_size, 0x00) {};
+
+    uint8_t read_rom(uint16_t addr) override
+    {
+        return Cartridge::rom_bytes(translate_rom_addr(addr));
+    };
+    const uint8_t *read_rom_ptr(uint16_t addr) override
+    {
+        // 0x4000-0x7FFF is switched too often to be worth remapping, the first bank only changes with the banking mode
+        if (0x4000 <= addr)
+            return nullptr;
+        return Cartridge::rom_ptr(translate_rom_addr(addr));
     };
     void write_rom(uint16_t addr, uint8_t value) override
     {
@@ -61,10 +73,14 @@ public:
             RAM_enabled = value;
         else if (0x2000 <= addr and addr <= 0x3FFF)
             ROM_bank_number = std::max(uint8_t(value & 0b11111), uint8_t(1));  // ROM Banking Number: 0x00 is treated as 0x01
-        else if (0x4000 <= addr and addr <= 0x5FFF)
+        else if (0x4000 <= addr and addr <= 0x5FFF) {
             RAM_bank_number = value & 0b11;
-        else if (0x6000 <= addr and addr <= 0x7FFF)
+            if (banking_mode_select) remap(); // selects the bank mapped to 0x0000-0x3FFF
+        }
+        else if (0x6000 <= addr and addr <= 0x7FFF) {
             banking_mode_select = value & 0b1;
+            remap();
+        }
     };
 
     // TODO: save RAM if BATTERY is available
@@ -101,5 +117,6 @@ public:
         RAM_bank_number = state.RAM_bank_number;
 
         banking_mode_select = state.banking_mode_select;
+        remap();
     }
 };
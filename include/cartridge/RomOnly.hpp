@@ -10,6 +10,12 @@ class ROM_ONLY : public Cartridge
         return Cartridge::rom_bytes(addr);
     }
 
+    // without an MBC the whole ROM is mapped permanently
+    const uint8_t *read_rom_ptr(uint16_t addr) override {
+        assert(addr <= 0x7FFF);
+        return Cartridge::rom_ptr(addr);
+    }
+
     uint8_t read_ram(uint16_t addr [[maybe_unused]]) override { return 0xFF; };
     void write_ram(uint16_t addr [[maybe_unused]], uint8_t value [[maybe_unused]]) override { /* As the name suggests ROM_ONLY does not have any RAM to write to. */ };
 
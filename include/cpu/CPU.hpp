@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include "cpu/instructions/Instruction.hpp"
@@ -25,7 +26,20 @@ class CPU : public Memory {
     MMU &mem_;
 
     CPU_STATES state = CPU_STATES::FetchOpcode;
-    std::unique_ptr<Instruction> instruction;
+
+    /* Progress of the currently executed `MultiCycleInstruction`. */
+    struct InstructionState {
+        uint8_t cycle = 0;
+        uint8_t temp_u8 = 0;
+        uint16_t temp_u16 = 0;
+    } instruction_state_;
+
+    /* All instructions indexed by opcode, the CB-prefixed ones start at 0x100. Illegal opcodes are nullptr. */
+    std::array<std::unique_ptr<Instruction>, 0x200> instructions_;
+    Instruction *instruction;
+
+    /* Returns the instruction for the given opcode and resets the instruction state. */
+    Instruction *decode(uint8_t opcode, bool extended);
 
     // Registers
     uint8_t A = 0x0;
@@ -120,6 +134,10 @@ class CPU : public Memory {
     public:
     CPU() = delete;
     CPU(MMU &mem, bool fast_boot) : mem_(mem) {
+        for (unsigned i = 0; i < instructions_.size(); ++i)
+            instructions_[i] = Instruction::Get(uint8_t(i & 0xFF), i > 0xFF, *this, mem_);
+        instruction = instructions_[0x00].get();    // NOP
+
         if (fast_boot) {
             // Initialize the CPU’s state to the state it should have immediately after executing the boot ROM
             A = 0x01;
@@ -138,6 +156,12 @@ class CPU : public Memory {
     /* Runs the CPU for one M-Cycle. */
     void tick();
 
+    /* Returns true if the CPU is in the middle of an instruction, i.e. the next M-Cycle continues the current one. */
+    bool executing() const { return state == CPU_STATES::Execute; }
+
+    /* Returns true if the CPU is in HALT mode and stays there until an interrupt is requested. */
+    bool halted() const { return state == CPU_STATES::HaltMode and not HALT_bug and not (IE_ & IF_); }
+
     bool contains_address(uint16_t addr) const override {
         return (addr == 0xFF0F) or (addr == 0xFFFF);
     }
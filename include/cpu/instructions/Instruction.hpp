@@ -101,21 +101,34 @@ class Instruction {
     uint8_t opcode() { return opcode_; }
     bool extended() { return extended_; }
 
+    /* Index of the instruction in the opcode table, the CB-prefixed instructions start at 0x100. */
+    uint16_t index() const { return extended_ ? uint16_t(0x100 | opcode_) : opcode_; }
+
     virtual InstructionSaveState save_state();
-    static std::unique_ptr<Instruction> load_state(InstructionSaveState state, CPU &cpu, MMU& mem);
+    virtual void load_state(const InstructionSaveState &state [[maybe_unused]]) { }
 
+    /* Constructs the instruction for the given opcode, returns nullptr for illegal opcodes.
+       Instructions are stateless and created once per CPU, see `CPU::instructions_`. */
     static std::unique_ptr<Instruction> Get(uint8_t opcode, bool extended, CPU &cpu, MMU& mem);
+
+    /* Executes one M-cycle of the given instruction, using the dispatch selected by YUMEBOY_CPU_DISPATCH:
+        virtual - virtual call of `execute()`
+        table   - flat table of free functions generated from the opcode tables, which call `execute()` non-virtually
+       Both only devirtualize the call, the instruction still picks its M-cycle with `next_cycle()`. */
+    static bool Execute(Instruction &instruction);
 };
 
 /* Represents a CPU instruction that takes longer than a single m-cycle, should be inhertited to implement explicit instructions. */
 class MultiCycleInstruction : public Instruction {
     friend Instruction;
 
-    uint8_t cycle_ = 0;
+    /* The progress of the instruction is stored in the CPU (see `CPU::instruction_state_`), so a single object can be
+       shared by every execution of the opcode. */
+    uint8_t &cycle_;
 
     protected:
-    uint8_t temp_u8;
-    uint16_t temp_u16;
+    uint8_t &temp_u8;
+    uint16_t &temp_u16;
 
     /* increments the cycle counter and returns the previous value. */
     uint8_t next_cycle() { return cycle_++; }
@@ -164,9 +177,10 @@ class MultiCycleInstruction : public Instruction {
     bool RST(uint8_t vector);
 
     public:
-    explicit MultiCycleInstruction(CPU &cpu, MMU &mem, uint8_t opcode, bool extended) : Instruction(cpu, mem, opcode, extended) { };
+    explicit MultiCycleInstruction(CPU &cpu, MMU &mem, uint8_t opcode, bool extended);
 
     InstructionSaveState save_state() override;
+    void load_state(const InstructionSaveState &state) override;
 };
 
 #define INSTRUCTION(op, name, superclass) \
@@ -4,11 +4,24 @@
 #include <cpu/InterruptBus.hpp>
 #include <mmu/Memory.hpp>
 
-class YumeBoy;
 struct JoypadSaveState;
 
+/** The buttons of the Game Boy. Which of them are held down is set by the front end (see `YumeBoyCore::set_input`). */
 class Joypad : public Memory {
-    YumeBoy &yume_boy_;
+    public:
+    struct Buttons {
+        bool start = false;
+        bool select = false;
+        bool b = false;
+        bool a = false;
+
+        bool down = false;
+        bool up = false;
+        bool left = false;
+        bool right = false;
+    };
+
+    private:
     InterruptBus &interrupts;
 
     struct JoypadState {
@@ -44,7 +57,7 @@ class Joypad : public Memory {
 
     public:
     Joypad() = delete;
-    explicit Joypad(YumeBoy &yume_boy, InterruptBus &interrupts) : yume_boy_(yume_boy), interrupts(interrupts) { }
+    explicit Joypad(InterruptBus &interrupts) : interrupts(interrupts) { }
 
     bool contains_address(uint16_t addr) const override {
         return addr == 0xFF00;
@@ -60,8 +73,9 @@ class Joypad : public Memory {
         P1(value);
     }
 
-    /* Handles `SDL_Event`s and updates P1 accrodingly and requests Interrupts if necessary. */
-    void update_joypad_state();
+    /* Updates the buttons that are held down and requests the joypad interrupt if one of them pulls a selected input
+       line of P1 low. */
+    void buttons(const Buttons &buttons);
 
     JoypadSaveState save_state() const;
     void load_state(JoypadSaveState state);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "YumeBoyCore.hpp"
+
+
+/** The keyboard input of the SDL front end: Z is B, X is A, Return is Start, Backspace is Select and the arrow keys are
+ * the D-Pad. Debug builds have hotkeys as well: 1 dumps the tilemap, 2 takes a screenshot, 3 saves and 4 loads the
+ * state. Requires the video subsystem of SDL, e.g. through an `SDLVideoSink`. The events are handled on the main thread,
+ * the buttons and hotkeys are passed on to the core on the thread that runs the emulation. */
+class SDLInput {
+    YumeBoyCore &core_;
+    Joypad::Buttons buttons_;   // only used by the main thread
+    std::atomic<Joypad::Buttons> pending_buttons_{ Joypad::Buttons{} };
+    std::atomic<bool> quit_requested_ = false;
+
+#ifndef NDEBUG
+    enum Hotkey : uint8_t {
+        DUMP_TILEMAP = 1 << 0,
+        SCREENSHOT = 1 << 1,
+        SAVE_STATE = 1 << 2,
+        LOAD_STATE = 1 << 3,
+    };
+    std::atomic<uint8_t> hotkeys_ = 0;  // the hotkeys pressed since the last `apply`
+
+    /* Saves the most recent frame as a BMP file. */
+    bool screenshot(const char *fileName) const;
+#endif
+
+    public:
+    explicit SDLInput(YumeBoyCore &core) : core_(core) { }
+
+    /* Handles the pending `SDL_Event`s, has to be called on the main thread like every event function of SDL. */
+    void poll();
+
+    /* Passes the buttons on to the core and runs the hotkeys pressed since the last call. SDL_PollEvent is expensive, so
+       this is called in between frames rather than while they are emulated, on the thread that runs the emulation. */
+    void apply();
+
+    /* Whether the window was closed, the emulation is not stopped by itself. */
+    bool quit_requested() const { return quit_requested_.load(std::memory_order_relaxed); }
+};
\ No newline at end of file
@@ -33,6 +33,9 @@ class DMA : public Memory {
     /* performs an M-cycle. */
     void tick();
 
+    /* Returns true if a transfer is pending or running. */
+    bool active() const { return dma_pending or dma_running; }
+
     bool contains_address(uint16_t addr) const override {
         return addr == 0xFF46;
     }
@@ -1,37 +1,187 @@
 #pragma once
 
 #include <mmu/Memory.hpp>
-#include <iostream>
-#include <format>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include "Diagnostics.hpp"
 
 
 class MMU {
+    friend Memory;
+
     std::vector<Memory *> memory_;
 
+    /* Maps an address range to the component handling it. If the range can be accessed without side effects
+       (see `Memory::read_ptr` and `Memory::write_ptr`), the backing memory is accessed directly instead. */
+    struct Mapping {
+        Memory *memory = nullptr;
+        const uint8_t *read = nullptr;
+        uint8_t *write = nullptr;
+    };
+
+    /* The address space is split into 256 pages sharing the same high byte. A page that is mapped by a single component
+       (or not mapped at all) resolves to that component directly and its `read`/`write` pointers refer to the first byte
+       of the page. Pages shared by multiple components, like the I/O registers at 0xFF00-0xFFFF, are resolved byte by
+       byte using a fine-grained sub-table whose `read`/`write` pointers refer to the mapped byte itself. */
+    struct Page : Mapping {
+        std::unique_ptr<std::array<Mapping, 0x100>> sub_table;
+    };
+    std::array<Page, 0x100> page_table_;
+
+    AccessCounters unmapped_accesses_{ "unmapped", 0x0000, 0xFFFF };
+
+    /* Returns the component mapped to the given address or nullptr if the address is unmapped. */
+    Memory *decode(uint16_t addr) const
+    {
+        const Page &page = page_table_[addr >> 8];
+        if (page.sub_table) [[unlikely]]
+            return (*page.sub_table)[addr & 0xFF].memory;
+        return page.memory;
+    }
+
+    /* Maps all addresses of the page that are claimed by the given component and not yet mapped by a previously added one. */
+    void map_page(uint8_t page_number, Memory *memory)
+    {
+        Page &page = page_table_[page_number];
+
+        std::array<Memory *, 0x100> row;
+        bool changed = false;
+        for (unsigned i = 0; i < row.size(); ++i) {
+            auto addr = uint16_t((page_number << 8) | i);
+            row[i] = decode(addr);
+            if (row[i] == nullptr and memory->contains_address(addr)) {
+                row[i] = memory;
+                changed = true;
+            }
+        }
+        if (not changed) return;
+
+        if (std::ranges::all_of(row, [&row](Memory *m) { return m == row[0]; })) {
+            page.memory = row[0];
+            page.sub_table = nullptr;
+        } else {
+            page.memory = nullptr;
+            page.sub_table = std::make_unique<std::array<Mapping, 0x100>>();
+            for (unsigned i = 0; i < row.size(); ++i)
+                (*page.sub_table)[i].memory = row[i];
+        }
+        map_pointers(page_number);
+    }
+
+    /* (Re-)determines which addresses of the page can be accessed directly through their backing memory. */
+    void map_pointers(uint8_t page_number)
+    {
+        Page &page = page_table_[page_number];
+        auto base = uint16_t(page_number << 8);
+
+        if (page.sub_table) {
+            for (unsigned i = 0; i < page.sub_table->size(); ++i) {
+                Mapping &m = (*page.sub_table)[i];
+                m.read = m.memory ? m.memory->read_ptr(uint16_t(base | i)) : nullptr;
+                m.write = m.memory ? m.memory->write_ptr(uint16_t(base | i)) : nullptr;
+            }
+            return;
+        }
+
+        page.read = page.memory ? page.memory->read_ptr(base) : nullptr;
+        page.write = page.memory ? page.memory->write_ptr(base) : nullptr;
+
+        // the backing memory can only be used for the whole page if it is contiguous
+        for (unsigned i = 1; i < 0x100 and (page.read or page.write); ++i) {
+            if (page.read and page.memory->read_ptr(uint16_t(base | i)) != page.read + i)
+                page.read = nullptr;
+            if (page.write and page.memory->write_ptr(uint16_t(base | i)) != page.write + i)
+                page.write = nullptr;
+        }
+    }
+
+    /* Updates the direct access pointers of all pages the component is mapped to. */
+    void remap(Memory *memory)
+    {
+        for (unsigned page_number = 0; page_number < page_table_.size(); ++page_number) {
+            const Page &page = page_table_[page_number];
+            if (page.memory == memory or (page.sub_table and std::ranges::any_of(*page.sub_table, [memory](const Mapping &m) { return m.memory == memory; })))
+                map_pointers(uint8_t(page_number));
+        }
+    }
+
     public:
     virtual ~MMU() = default;
     MMU() = default;
 
+    /* Maps the given component into the address space. If components overlap, the component that was added first takes precedence. */
     void add(Memory *memory)
     {
         memory_.push_back(memory);
+        memory->mmu_ = this;
+        for (unsigned page_number = 0; page_number < page_table_.size(); ++page_number)
+            map_page(uint8_t(page_number), memory);
     }
 
+    /* Maps the replacement to all addresses the given component is mapped to, e.g. to wrap the component. */
+    void replace(Memory *memory, Memory *replacement)
+    {
+        std::ranges::replace(memory_, memory, replacement);
+        replacement->mmu_ = this;
+        for (unsigned page_number = 0; page_number < page_table_.size(); ++page_number) {
+            Page &page = page_table_[page_number];
+            bool changed = false;
+            if (page.memory == memory) {
+                page.memory = replacement;
+                changed = true;
+            }
+            if (page.sub_table) {
+                for (Mapping &m : *page.sub_table) {
+                    if (m.memory == memory) {
+                        m.memory = replacement;
+                        changed = true;
+                    }
+                }
+            }
+            if (changed)
+                map_pointers(uint8_t(page_number));
+        }
+    }
+
+    /* The accesses to addresses that are not mapped to any component, which are ignored. */
+    AccessCounters &unmapped_accesses() { return unmapped_accesses_; }
+
     virtual uint8_t read_memory(uint16_t addr)
     {
-        auto it = std::ranges::find_if(memory_, [addr](Memory *m) { return m->contains_address(addr); });
-        if(it != memory_.end())
-            return (*it)->read_memory(addr);
-        std::cerr << std::format("Address {:#04X} is read from which is undocumented! Returning 0xFF.\n", addr);
+        const Page &page = page_table_[addr >> 8];
+        if (page.read) [[likely]]
+            return page.read[addr & 0xFF];
+
+        const Mapping &m = page.sub_table ? (*page.sub_table)[addr & 0xFF] : static_cast<const Mapping &>(page);
+        if (m.read)
+            return *m.read;
+        if (m.memory) [[likely]]
+            return m.memory->read_memory(addr);
+        unmapped_accesses_.count(AccessCounters::Access::Read, addr);
         return 0xFF;
     }
 
     virtual void write_memory(uint16_t addr, uint8_t value)
     {
-        auto it = std::ranges::find_if(memory_, [addr](Memory *m) { return m->contains_address(addr); });
-        if(it != memory_.end())
-            (*it)->write_memory(addr, value);
+        const Page &page = page_table_[addr >> 8];
+        if (page.write) [[likely]] {
+            page.write[addr & 0xFF] = value;
+            return;
+        }
+
+        const Mapping &m = page.sub_table ? (*page.sub_table)[addr & 0xFF] : static_cast<const Mapping &>(page);
+        if (m.write)
+            *m.write = value;
+        else if (m.memory) [[likely]]
+            m.memory->write_memory(addr, value);
         else
-            std::cerr << std::format("Address {:#04X} is written to which is undocumented! Ignoring write operation.\n", addr);
+            unmapped_accesses_.count(AccessCounters::Access::Write, addr, value);
     }
-};
\ No newline at end of file
+};
+
+inline void Memory::remap()
+{
+    if (mmu_)
+        mmu_->remap(this);
+}
\ No newline at end of file
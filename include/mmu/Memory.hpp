@@ -5,8 +5,16 @@
 #include <vector>
 
 
+class MMU;
+
 class Memory {
-    
+    friend MMU;
+    MMU *mmu_ = nullptr;    // the MMU this component is mapped into
+
+    protected:
+    /* Notifies the MMU that the memory returned by `read_ptr` or `write_ptr` changed, e.g. because a different bank was mapped. */
+    void remap();
+
     public:
     Memory() = default;
     virtual ~Memory() = default;;
@@ -16,4 +24,12 @@ class Memory {
     virtual uint8_t read_memory(uint16_t addr) = 0;
 
     virtual void write_memory(uint16_t addr, uint8_t value) = 0;
+
+    /* Returns a pointer to the byte backing the given address if reading it has no side effects, nullptr otherwise.
+       The MMU uses it to bypass `read_memory` for plain memory like RAM or fixed ROM banks. */
+    virtual const uint8_t *read_ptr(uint16_t addr [[maybe_unused]]) { return nullptr; }
+
+    /* Returns a pointer to the byte backing the given address if writing it has no side effects, nullptr otherwise.
+       The MMU uses it to bypass `write_memory` for plain memory like RAM. */
+    virtual uint8_t *write_ptr(uint16_t addr [[maybe_unused]]) { return nullptr; }
 };
\ No newline at end of file
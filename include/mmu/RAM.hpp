@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include "mmu/Memory.hpp"
+#include "mmu/MMU.hpp"
 #include <savestate/RAMSaveState.hpp>
 
 
@@ -34,6 +35,18 @@ class RAM : public Memory {
         memory_[addr - begin_memory_range_] = value;
     }
 
+    const uint8_t *read_ptr(uint16_t addr) override
+    {
+        assert(begin_memory_range_ <= addr and addr <= end_memory_range_);
+        return &memory_[addr - begin_memory_range_];
+    }
+
+    uint8_t *write_ptr(uint16_t addr) override
+    {
+        assert(begin_memory_range_ <= addr and addr <= end_memory_range_);
+        return &memory_[addr - begin_memory_range_];
+    }
+
     RAMSaveState save_state() {
         RAMSaveState s = {
             memory_,
@@ -47,5 +60,6 @@ class RAM : public Memory {
         memory_ = state.memory_;
         assert(begin_memory_range_ == state.begin_memory_range_);
         assert(end_memory_range_ == state.end_memory_range_);
+        remap();
     }
 };
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "mmu/Memory.hpp"
+
+
+/** Maps a component that is not ticked in lock-step with the CPU into the address space. Before every access through the
+ * memory bus `sync` is called, which has to catch up the component to the cycle the access happens at. */
+class SynchronizedMemory : public Memory {
+    Memory &memory_;
+    std::function<void()> sync_;
+
+    public:
+    SynchronizedMemory(Memory &memory, std::function<void()> sync) : memory_(memory), sync_(std::move(sync)) { }
+
+    bool contains_address(uint16_t addr) const override {
+        return memory_.contains_address(addr);
+    }
+
+    uint8_t read_memory(uint16_t addr) override {
+        sync_();
+        return memory_.read_memory(addr);
+    }
+
+    void write_memory(uint16_t addr, uint8_t value) override {
+        sync_();
+        memory_.write_memory(addr, value);
+    }
+};
\ No newline at end of file
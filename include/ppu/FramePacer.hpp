@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+
+/** Keeps the emulation in step with real time by letting the emulation thread sleep after each frame until the next
+ * frame is due. */
+class FramePacer {
+    using clock = std::chrono::steady_clock;
+
+    public:
+    /* How late the emulation thread woke up after the frames were due, sleeping is never exact. */
+    struct Jitter {
+        clock::duration last{};
+        clock::duration max{};
+        clock::duration total{};
+        uint64_t frames = 0;
+
+        clock::duration mean() const { return frames ? total / int64_t(frames) : clock::duration::zero(); }
+    };
+
+    private:
+    clock::duration frame_time_;
+    double rate_ = 1;
+    clock::time_point next_frame_;
+    Jitter jitter_;
+
+    public:
+    explicit FramePacer(clock::duration frame_time) : frame_time_(frame_time), next_frame_(clock::now() + frame_time) { }
+
+    /* The time between two frames, zero if the emulation is not paced at all. */
+    clock::duration frame_time() const { return frame_time_; }
+    void frame_time(clock::duration frame_time)
+    {
+        frame_time_ = frame_time;
+        next_frame_ = clock::now() + frame_time;
+    }
+
+    /* The frame time is divided by the rate, e.g. to run the emulation slightly faster or slower than real time. The
+       rate takes effect from the next frame on. */
+    double rate() const { return rate_; }
+    void rate(double rate) { rate_ = rate; }
+
+    /* Waits until the next frame is due. If the emulation fell behind by more than a frame, it does not try to catch up. */
+    void wait()
+    {
+        if (frame_time_ == clock::duration::zero()) return;
+
+        std::this_thread::sleep_until(next_frame_);
+        clock::time_point now = clock::now();
+
+        jitter_.last = std::max(now - next_frame_, clock::duration::zero());
+        jitter_.max = std::max(jitter_.max, jitter_.last);
+        jitter_.total += jitter_.last;
+        ++jitter_.frames;
+
+        next_frame_ = std::max(next_frame_ + std::chrono::duration_cast<clock::duration>(frame_time_ / rate_), now);
+    }
+
+    const Jitter &jitter() const { return jitter_; }
+
+    /* The time until the next frame is due. */
+    clock::duration time_left() const
+    {
+        return std::max(next_frame_ - clock::now(), clock::duration::zero());
+    }
+
+    /* Lets the next frame be due after the given time, but not later than a frame from now. */
+    void delay(clock::duration time_left)
+    {
+        next_frame_ = clock::now() + std::min(time_left, frame_time_);
+    }
+};
\ No newline at end of file
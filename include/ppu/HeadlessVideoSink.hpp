@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "ppu/VideoSink.hpp"
+
+
+/** Keeps the most recent frame in memory instead of displaying it, e.g. for batch runs without a display. */
+class HeadlessVideoSink : public VideoSink {
+    Frame frame_{};
+    uint64_t frame_count_ = 0;
+
+    public:
+    void present(const Frame &frame, const DirtyLines &dirty_lines) override
+    {
+        constexpr size_t LINE = WIDTH * 4;
+        for (size_t y = 0; y < HEIGHT; ++y)
+            if (dirty_lines[y])
+                std::copy_n(frame.begin() + y * LINE, LINE, frame_.begin() + y * LINE);
+        ++frame_count_;
+    }
+
+    /* The most recently completed frame. */
+    const Frame &frame() const { return frame_; }
+
+    /* The number of frames completed so far. */
+    uint64_t frame_count() const { return frame_count_; }
+};
\ No newline at end of file
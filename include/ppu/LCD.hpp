@@ -1,37 +1,71 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <memory>
-#include <SDL3/SDL.h>
+#include <span>
+#include <utility>
+#include "ppu/FramePacer.hpp"
+#include "ppu/VideoSink.hpp"
 
 
 struct LCDSaveState;
 
 class LCD {
     public:
-    static const uint8_t DISPLAY_WIDTH = 160;
-    static const uint8_t DISPLAY_HEIGHT = 144;
+    static const uint8_t DISPLAY_WIDTH = VideoSink::WIDTH;
+    static const uint8_t DISPLAY_HEIGHT = VideoSink::HEIGHT;
     static constexpr uint64_t FRAME_NS = 16740000;  // number of nanoseconds between frames
+    static constexpr uint64_t FRAME_T_CYCLES = 154 * 456;   // 154 scanlines of 456 T-cycles each
 
-    using pixel_buffer_t = std::array<uint8_t, DISPLAY_WIDTH * DISPLAY_HEIGHT * 4>;
+    using pixel_buffer_t = VideoSink::Frame;
 
-    private:
-    struct sdl_deleter
+    /* Packs a color the way it is stored in the pixel buffer (RGBA32). */
+    static constexpr uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
     {
-        void operator()(SDL_Window *p) const { SDL_DestroyWindow(p); }
-        void operator()(SDL_Renderer *p) const { SDL_DestroyRenderer(p); }
-        void operator()(SDL_Texture *p) const { SDL_DestroyTexture(p); }
-    };
+        if constexpr (std::endian::native == std::endian::little)
+            return r | (g << 8) | (b << 16) | (uint32_t(a) << 24);
+        else
+            return (uint32_t(r) << 24) | (g << 16) | (b << 8) | a;
+    }
 
-    std::unique_ptr<SDL_Window, sdl_deleter> window;
-    std::unique_ptr<SDL_Renderer, sdl_deleter> renderer;
-    std::unique_ptr<SDL_Texture, sdl_deleter> pixel_matrix_texture;
+    private:
+    std::unique_ptr<VideoSink> sink;    // receives the completed frames, none if they are not presented at all
     pixel_buffer_t pixel_buffer;
     pixel_buffer_t::iterator buffer_it;
 
     bool power_ = false;
 
-    uint64_t next_frame = FRAME_NS;   // time until the next frame should be rendered, time given in nanoseconds
+    /* The scanlines that changed since the last presented frame. A scanline is dirty as soon as a pixel is pushed that
+       differs from the pixel of the previous frame it overwrites. */
+    VideoSink::DirtyLines dirty_lines;
+    bool blank_presented = false;   // whether the last presented frame was blank because the LCD was turned off
+
+    /* The packed colors of the four shades of gray, see `Color`. */
+    std::array<uint32_t, 4> color_scheme_ = {
+        rgba(233, 239, 236),
+        rgba(160, 160, 139),
+        rgba(85, 85, 104),
+        rgba(33, 30, 32),
+    };
+
+    FramePacer pacer{ std::chrono::nanoseconds(FRAME_NS) };
+
+    uint8_t frame_skip_ = 0;        // number of frames that are not presented after each presented frame
+    uint8_t frames_to_skip = 0;     // number of frames that are not presented before the next presented frame
+
+    public:
+    /* Counts the presented frames by how many of their scanlines changed since the previous presented frame. */
+    struct FrameCounters {
+        uint64_t unchanged = 0;     // no scanline changed, so the frame does not have to be uploaded or presented
+        uint64_t partial = 0;       // only some scanlines changed and have to be uploaded
+        uint64_t full = 0;          // all scanlines changed
+    };
+
+    private:
+    FrameCounters frame_counters_;
 
     public:
     enum class Color : uint8_t {
@@ -41,27 +75,60 @@ class LCD {
         BLACK = 3
     };
 
-    LCD([[maybe_unused]] const char *title, [[maybe_unused]] int width, [[maybe_unused]] int height) : buffer_it(pixel_buffer.begin()) {
-        SDL_Init(SDL_INIT_VIDEO);
-
-        window = std::unique_ptr<SDL_Window, sdl_deleter>(SDL_CreateWindow("YumeBoy", DISPLAY_WIDTH * 4, DISPLAY_HEIGHT * 4, SDL_WINDOW_BORDERLESS), sdl_deleter());
-        renderer = std::unique_ptr<SDL_Renderer, sdl_deleter>(SDL_CreateRenderer(window.get(), nullptr), sdl_deleter());
-        pixel_matrix_texture =  std::unique_ptr<SDL_Texture, sdl_deleter>(SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, DISPLAY_WIDTH, DISPLAY_HEIGHT), sdl_deleter());
-        /* use nearest pixel scaling mode for a pixel perfect image */
-        SDL_SetTextureScaleMode(pixel_matrix_texture.get(), SDL_SCALEMODE_NEAREST);
+    explicit LCD(std::unique_ptr<VideoSink> sink) : sink(std::move(sink)), buffer_it(pixel_buffer.begin()) {
+        dirty_lines.set();
     }
 
     void power(bool on) { power_ = on; }
 
-    void push_pixel(Color c);
+    /* Returns the packed color the given shade is displayed with. */
+    uint32_t color(Color c) const { return color_scheme_[std::to_underlying(c)]; }
 
+    /* Changes the packed colors the four shades are displayed with, the PPU has to update its palettes afterwards. */
+    void color_scheme(const std::array<uint32_t, 4> &colors) { color_scheme_ = colors; }
+
+    /* Pushes a packed color (see `color`) to the pixel buffer. */
+    void push_pixel(uint32_t color);
+
+    /* Pushes multiple packed colors of the same scanline at once, e.g. a whole scanline. */
+    void push_pixels(std::span<const uint32_t> colors);
+
+    const FrameCounters &frame_counters() const { return frame_counters_; }
+
+    /* The number of pixels that have been pushed for the current frame. */
+    size_t pushed_pixels() const { return size_t(buffer_it - pixel_buffer.begin()) / 4; }
+
+    /* Passes the completed frame on to the video sink and waits until the next frame is due. */
     void update_screen();
 
+    /* Completes a frame whose pixels have not been pushed since it is not presented (see `skipping_frame`) and waits
+       until the next frame is due. */
+    void skip_frame();
+
+    /* The speed of the emulation relative to a real Game Boy, e.g. 1 for real time or 4 to fast-forward.
+       A speed of 0 runs the emulation as fast as possible. */
+    double speed() const;
+    void speed(double speed);
+
+    /* The frame time is divided by the pacing rate, which is kept close to 1 to correct the speed slightly. */
+    double pacing_rate() const { return pacer.rate(); }
+    void pacing_rate(double rate) { pacer.rate(rate); }
+
+    /* How late the emulation woke up after the frames were due. */
+    const FramePacer::Jitter &frame_jitter() const { return pacer.jitter(); }
+
+    /* The number of frames that are emulated but not presented after each presented frame. */
+    uint8_t frame_skip() const { return frame_skip_; }
+    void frame_skip(uint8_t frames)
+    {
+        frame_skip_ = frames;
+        frames_to_skip = std::min(frames_to_skip, frames);
+    }
+
+    /* Whether the next completed frame is not going to be presented, so its pixels do not have to be pushed. */
+    bool skipping_frame() const { return frames_to_skip != 0 or not sink; }
+
     LCDSaveState save_state();
 
     void load_state(LCDSaveState state);
-    
-#ifndef NDEBUG
-    bool screenshot(const char* fileName) const;
-#endif
 };
\ No newline at end of file
@@ -5,11 +5,14 @@
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <stdexcept>
 #include <vector>
 #include <cpu/InterruptBus.hpp>
 #include "ppu/PixelFetcher.hpp"
+#include "ppu/PixelFIFO.hpp"
+#include "ppu/TileCache.hpp"
 #include "ppu/states.hpp"
 #include "mmu/Memory.hpp"
 
@@ -23,22 +26,21 @@ constexpr uint16_t LCD_REG_END = 0xFF4B;
 class YumeBoy;
 class LCD;
 struct PPUSaveState;
-struct OAMEntrySaveState;
-
-struct OAM_entry {
-    uint8_t y;
-    uint8_t x;
-    uint8_t tile_id;
-    uint8_t flags;
-    
-    OAMEntrySaveState save_state() const;
-    static std::unique_ptr<OAM_entry> load_state(OAMEntrySaveState state);
-};
 
 /** The Pixel-Processing Unit. It handles anything related to drawing the frames of games. */
 class PPU : public Memory {
     friend PixelFetcher;
-    
+
+    public:
+    /* How the pixels of a scanline are composed, both push the same pixels in the same T-cycles to the LCD:
+        Scanline - the whole scanline at once when the pixel transfer begins (see `render_scanline`)
+        FIFO     - pixel by pixel by the pixel FIFO, as the hardware does */
+    enum class Renderer {
+        Scanline,
+        FIFO,
+    };
+
+    private:
     LCD &lcd;
 
     MMU &mem;
@@ -50,6 +52,7 @@ class PPU : public Memory {
 
     std::vector<uint8_t> vram_;
     std::vector<uint8_t> oam_ram_;
+    TileCache tile_cache;   // the decoded rows of the tiles in `vram_`
 
     /* LCD Registers */
     /** 0xFF40 — LCDC: the main LCD Control register.
@@ -94,6 +97,13 @@ class PPU : public Memory {
      * These registers assigns gray shades to the color indexes of the OBJs that use the corresponding palette.
      * They work exactly like BGP, except that the lower two bits are ignored because color index 0 is transparent for OBJs. */
     uint8_t OBP1 = 0x0;
+    /* The packed colors of the color IDs of BGP, OBP0 and OBP1 (indexed by `ColorPallet`), updated whenever one of
+       these registers is written. */
+    std::array<std::array<uint32_t, 4>, 3> palettes;
+
+    /* Updates the colors of a palette from its register. */
+    void update_palette(ColorPallet pallet);
+
     /** 0xFF4A — WY: Window Y position. (WY=0-143) */
     uint8_t WY = 0x0;
     /** 0xFF4B — WX: Window X position plus 7. (WX=7-166) */
@@ -103,14 +113,47 @@ class PPU : public Memory {
 
     /* OAM specific */
     uint16_t oam_pointer = OAM_RAM_BEGIN;
-    std::vector<std::unique_ptr<OAM_entry>> scanline_sprites;
+    /* The (up to 10) sprites on the current scanline found by the OAM scan, sorted by their X position. Sprites with the
+       same X position keep their OAM order. `next_sprite` is the first sprite the fetcher has not fetched yet. */
+    std::array<OAM_entry, 10> scanline_sprites;
+    uint8_t scanline_sprite_count = 0;
+    uint8_t next_sprite = 0;
 
     /* Pixel FIFO and Fetcher */
-    std::queue<Pixel> BG_FIFO;
-    std::queue<Pixel> Sprite_FIFO;
+    PixelFIFO BG_FIFO;
+    PixelFIFO Sprite_FIFO;
     uint8_t fifo_pushed_pixels = 0; // current x position of the pixel fifo
     PixelFetcher fetcher;
 
+    /* Frame skipping: the pixels of a frame that is not presented (see `LCD::skipping_frame`) are neither composed nor
+       pushed to the LCD, only the timing of the pixel transfer is determined. Decided when the frame begins. */
+    bool skip_frame = false;
+
+    /* Scanline renderer
+       Unless a register that affects the picture is written during the pixel transfer (VRAM and OAM are inaccessible),
+       the pixel FIFO pushes a scanline that only depends on the state at the beginning of the pixel transfer. Therefore,
+       the whole scanline is rendered at once when the pixel transfer begins and only pushed to the LCD when the pixel
+       FIFO would have pushed its last pixel. If such a register is written in between, the pixel FIFO takes over. */
+    Renderer renderer_ = Renderer::Scanline;
+    bool scanline_rendered = false;         // the current scanline has been rendered by `render_scanline()`
+    uint32_t pixel_transfer_end = 0;        // the `scanline_time_` at which the rendered scanline is finished
+    std::array<uint32_t, 160> scanline;     // the packed colors of the rendered scanline
+
+    /* Renders the current scanline (unless the frame is skipped) and determines when the pixel FIFO would have
+       finished it. */
+    void render_scanline();
+
+    /* Pushes the rendered scanline to the LCD and moves on to H-Blank. */
+    void finish_scanline();
+
+    /* Runs the pixel FIFO from the beginning of the pixel transfer up to (and including) the given T-cycle of the
+       scanline, so the pixel transfer of a rendered scanline can be continued by the pixel FIFO. */
+    void replay_pixel_transfer(uint32_t until);
+
+    /* Returns the packed color of a BG pixel after it has been merged with the sprite pixel on top of it. A sprite pixel
+       with color 0 is transparent, so it can be used if there is no sprite pixel. */
+    uint32_t color(Pixel px, Pixel sp) const;
+
     /* Increment LY and update STAT register */
     void next_scanline();
 
@@ -131,6 +174,7 @@ public:
     explicit PPU(LCD &lcd, MMU &mem, InterruptBus &interrupts) : lcd(lcd), mem(mem), interrupts(interrupts), fetcher(*this) {
         vram_.resize(VRAM_END - VRAM_BEGIN + 1, 0);
         oam_ram_.resize(OAM_RAM_END - OAM_RAM_BEGIN + 1, 0);
+        update_palettes();
         
         set_mode(PPU_STATES::OAMScan);
     }
@@ -139,6 +183,12 @@ public:
     uint8_t read_memory(uint16_t addr) override;
     void write_memory(uint16_t addr, uint8_t value) override;
 
+    Renderer renderer() const { return renderer_; }
+    void renderer(Renderer renderer);
+
+    /* Updates the colors of all palettes, e.g. after the color scheme of the LCD changed. */
+    void update_palettes();
+
     void h_blank_tick();
     void v_blank_tick();
     void oam_scan_tick();
@@ -147,7 +197,14 @@ public:
     /* Runs the PPU for a single T-Cycle. */
     void tick();
 
-    PPUSaveState save_state() const;
+    /* Runs the PPU for the given number of T-Cycles. */
+    void tick(uint32_t t_cycles);
+
+    /* Returns a lower bound of the T-Cycles until the PPU might request an interrupt, nothing if the LCD is turned off. */
+    std::optional<uint32_t> cycles_until_event() const;
+
+    PPUSaveState save_state();
 
+    /* The state of the LCD has to be loaded first. */
     void load_state(PPUSaveState ppu_state);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <span>
+#include "ppu/PixelFetcher.hpp"
+
+
+/** A pixel FIFO with a fixed capacity that stores its pixels inline in a ring buffer.
+ * The fetcher pushes at most a whole tile row (8 pixels) at once, so neither FIFO ever holds more than that. */
+class PixelFIFO {
+    static constexpr size_t CAPACITY = 8;
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "the capacity must be a power of two");
+
+    std::array<Pixel, CAPACITY> pixels_;
+    uint8_t head_ = 0;  // index of the front pixel
+    uint8_t size_ = 0;
+
+    public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    const Pixel &front() const
+    {
+        assert(not empty());
+        return pixels_[head_];
+    }
+
+    void push(const Pixel &pixel)
+    {
+        assert(size_ < CAPACITY);
+        pixels_[(head_ + size_++) % CAPACITY] = pixel;
+    }
+
+    /* Pushes multiple pixels at once, e.g. a decoded tile row. */
+    void push(std::span<const Pixel> pixels)
+    {
+        assert(size_ + pixels.size() <= CAPACITY);
+        for (const Pixel &pixel : pixels)
+            pixels_[(head_ + size_++) % CAPACITY] = pixel;
+    }
+
+    void pop(size_t count = 1)
+    {
+        assert(count <= size_);
+        head_ = (head_ + count) % CAPACITY;
+        size_ -= uint8_t(count);
+    }
+
+    void clear()
+    {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    /* The FIFOs are saved as queues to keep the save state format. */
+    std::queue<Pixel> save_state() const
+    {
+        std::queue<Pixel> queue;
+        for (uint8_t i = 0; i < size_; ++i)
+            queue.push(pixels_[(head_ + i) % CAPACITY]);
+        return queue;
+    }
+
+    void load_state(std::queue<Pixel> queue)
+    {
+        clear();
+        for (; not queue.empty(); queue.pop())
+            push(queue.front());
+    }
+};
\ No newline at end of file
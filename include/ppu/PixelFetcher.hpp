@@ -10,7 +10,7 @@
 
 
 /* Pixel FIFO & Fetcher */
-enum ColorPallet {BG, S0, S1};
+enum ColorPallet : uint8_t {BG, S0, S1};
 struct Pixel {
     uint8_t color;
     ColorPallet pallet;
@@ -28,8 +28,19 @@ struct Pixel {
     }
 };
 
+struct OAMEntrySaveState;
+
+struct OAM_entry {
+    uint8_t y;
+    uint8_t x;
+    uint8_t tile_id;
+    uint8_t flags;
+    
+    OAMEntrySaveState save_state() const;
+    static OAM_entry load_state(OAMEntrySaveState state);
+};
+
 class PPU;
-struct OAM_entry;
 struct PixelFetcherSaveState;
 
 class PixelFetcher {
@@ -38,7 +49,7 @@ class PixelFetcher {
     bool fetch_window = false;
     PPU &p;
 
-    std::unique_ptr<OAM_entry> oam_entry;
+    OAM_entry oam_entry = {};
 
     uint8_t tile_id;
     uint8_t low_data;
@@ -51,7 +62,7 @@ class PixelFetcher {
 
     void tick();
 
-    void fetch_sprite(std::unique_ptr<OAM_entry> entry);
+    void fetch_sprite(OAM_entry entry);
 
     void reset();
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <SDL3/SDL.h>
+#include "ppu/TripleBuffer.hpp"
+#include "ppu/VideoSink.hpp"
+
+
+/** Displays the frames in an SDL window. SDL only allows its video functions on the main thread, so the emulation runs
+ * on another thread and hands the frames over to the main thread, which uploads and presents them (see `show_latest`).
+ * The emulation never waits for the renderer (or the GPU). */
+class SDLVideoSink : public VideoSink {
+    struct sdl_deleter
+    {
+        void operator()(SDL_Window *p) const { SDL_DestroyWindow(p); }
+        void operator()(SDL_Renderer *p) const { SDL_DestroyRenderer(p); }
+        void operator()(SDL_Texture *p) const { SDL_DestroyTexture(p); }
+    };
+
+    // only used by the main thread
+    std::unique_ptr<SDL_Window, sdl_deleter> window;
+    std::unique_ptr<SDL_Renderer, sdl_deleter> renderer;
+    std::unique_ptr<SDL_Texture, sdl_deleter> pixel_matrix_texture;
+    uint64_t presented = 0;     // the number of the frame in the texture
+
+    /* A frame handed over to the main thread. Its dirty lines are relative to the previous frame, which the main thread
+       may not have seen if it has been replaced before the main thread took it. */
+    struct PublishedFrame {
+        Frame frame;
+        DirtyLines dirty_lines;
+        uint64_t number;
+    };
+
+    TripleBuffer<PublishedFrame> frames;
+    uint64_t published_frames = 0;
+    Uint32 frame_event = 0;     // pushed for every published frame to wake up the main thread, 0 if unavailable
+
+    public:
+    /* Opens the window, has to be called on the main thread. */
+    SDLVideoSink(const char *title, int width, int height);
+    ~SDLVideoSink() override;
+
+    /* Called on the thread that runs the emulation. */
+    void present(const Frame &frame, const DirtyLines &dirty_lines) override;
+
+    /* Uploads and presents the most recently published frame unless it has been presented already, has to be called on
+       the main thread. Every published frame pushes an `SDL_Event`, so the main thread can wait for events. */
+    void show_latest();
+};
\ No newline at end of file
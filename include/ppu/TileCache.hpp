@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+
+/** Caches every row of tile data in VRAM decoded to one color ID (0-3) per pixel, ordered from left to right, as well as
+ * horizontally flipped. A row is stored for every two bytes of VRAM since the fetcher can also read tile data from the
+ * tile maps (see `PixelFetcher::tick`). Every write to VRAM has to be passed on to `update`. */
+class TileCache {
+    public:
+    using Row = std::array<uint8_t, 8>;
+    static constexpr size_t ROWS = 0x2000 / 2;
+
+    private:
+    std::array<Row, ROWS> rows_{};
+    std::array<Row, ROWS> flipped_rows_{};
+
+    /* Moves bit i of the given byte to bit 0 of byte i. */
+    static uint64_t spread(uint8_t bits)
+    {
+    #if defined(__BMI2__)
+        return _pdep_u64(bits, 0x0101010101010101);
+    #else
+        static constexpr auto SPREAD = [] {
+            std::array<uint64_t, 0x100> table{};
+            for (unsigned b = 0; b < table.size(); ++b)
+                for (unsigned i = 0; i < 8; ++i)
+                    table[b] |= uint64_t((b >> i) & 1) << (8 * i);
+            return table;
+        }();
+        return SPREAD[bits];
+    #endif
+    }
+
+    public:
+    /* Decodes a row of a tile given by its two bytes of tile data. The leftmost pixel is stored in the most significant
+       bit, unless the row is flipped horizontally. */
+    static Row decode(uint8_t low_data, uint8_t high_data, bool flipped = false)
+    {
+        // byte i holds the color of bit i, which is the order of the flipped row
+        uint64_t colors = spread(low_data) | (spread(high_data) << 1);
+        if (not flipped)
+            colors = std::byteswap(colors);
+        if constexpr (std::endian::native == std::endian::big)
+            colors = std::byteswap(colors);
+
+        Row row;
+        std::memcpy(row.data(), &colors, row.size());
+        return row;
+    }
+
+    /* Returns the decoded row whose tile data begins at the given offset into VRAM. */
+    const Row &row(uint16_t offset, bool flipped = false) const
+    {
+        assert(offset % 2 == 0 and offset / 2 < ROWS);
+        return flipped ? flipped_rows_[offset / 2] : rows_[offset / 2];
+    }
+
+    /* Decodes the row again that contains the byte at the given offset into VRAM. */
+    void update(const std::vector<uint8_t> &vram, uint16_t offset)
+    {
+        offset &= ~1;
+        rows_[offset / 2] = decode(vram[offset], vram[offset + 1]);
+        flipped_rows_[offset / 2] = decode(vram[offset], vram[offset + 1], true);
+    }
+
+    /* Decodes all rows of the given VRAM, e.g. after loading a save state. */
+    void rebuild(const std::vector<uint8_t> &vram)
+    {
+        assert(vram.size() == 2 * ROWS);
+        for (uint16_t offset = 0; offset < vram.size(); offset += 2)
+            update(vram, offset);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+/** Hands over values (e.g. frames) from a producer thread to a consumer thread without locks. The producer writes into
+ * the back buffer and publishes it, the consumer always takes the most recently published buffer. Neither side ever
+ * waits for the other, unpublished values are dropped if the consumer is too slow. */
+template <typename T>
+class TripleBuffer {
+    static constexpr uint8_t INDEX = 0b11;
+    static constexpr uint8_t FRESH = 1 << 2;     // the middle buffer has been published but not taken yet
+
+    std::array<T, 3> buffers_{};
+    uint8_t back_ = 0;                  // only used by the producer
+    std::atomic<uint8_t> middle_ = 1;   // the buffer that is swapped between producer and consumer and the flag
+    uint8_t front_ = 2;                 // only used by the consumer
+
+    public:
+    /* Producer: the buffer to write the next value into. */
+    T &back() { return buffers_[back_]; }
+
+    /* Producer: publishes the back buffer and continues with the buffer the consumer has not taken (or has released). */
+    void publish() { back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX; }
+
+    /* Consumer: takes the most recently published value, returns false if nothing has been published since the last call. */
+    bool acquire()
+    {
+        // only the consumer clears the flag, so the middle buffer stays fresh until it is swapped
+        if (not (middle_.load(std::memory_order_relaxed) & FRESH))
+            return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /* Consumer: the most recently taken value. */
+    const T &front() const { return buffers_[front_]; }
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+
+/** Receives the frames completed by the `LCD`, e.g. to display them in a window. */
+class VideoSink {
+    public:
+    static constexpr uint8_t WIDTH = 160;
+    static constexpr uint8_t HEIGHT = 144;
+
+    /* A frame with one RGBA32 pixel (see `LCD::rgba`) per dot, row by row. */
+    using Frame = std::array<uint8_t, WIDTH * HEIGHT * 4>;
+
+    /* The scanlines of a frame that differ from the previously presented frame. */
+    using DirtyLines = std::bitset<HEIGHT>;
+
+    virtual ~VideoSink() = default;
+
+    /* Called on the emulation thread for every completed frame, the frame is only valid during the call. Only the dirty
+       scanlines differ from the frame of the previous call, all of them are dirty in the first call. */
+    virtual void present(const Frame &frame, const DirtyLines &dirty_lines) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <apu/APU.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/array.hpp>
+
+
+/* Represents the state of a `APU` object. The state has to be taken after the recorded writes have been synthesized. */
+struct APUSaveState {
+    uint64_t time_;
+    std::array<uint8_t, 0x30> registers_;
+    std::array<uint8_t, 0x30> applied_;
+    std::array<APU::Channel, 4> channels;
+    uint8_t frame_sequencer_step;
+    uint64_t next_sample;
+    uint32_t sample_remainder;
+    std::array<float, 2> high_pass_charge;
+
+    private:
+    friend class boost::serialization::access;
+
+    template<class Archive>
+    void serialize(Archive & ar, [[maybe_unused]] const unsigned int version)
+    {
+        ar & time_;
+        ar & registers_;
+        ar & applied_;
+        ar & channels;
+        ar & frame_sequencer_step;
+        ar & next_sample;
+        ar & sample_remainder;
+        ar & high_pass_charge;
+    }
+};
+
+namespace boost::serialization {
+    template<class Archive>
+    void serialize(Archive & ar, APU::Channel &ch, [[maybe_unused]] const unsigned int version)
+    {
+        ar & ch.enabled;
+        ar & ch.length_enabled;
+        ar & ch.length;
+        ar & ch.volume;
+        ar & ch.envelope_timer;
+        ar & ch.timer;
+        ar & ch.step;
+        ar & ch.lfsr;
+        ar & ch.sweep_enabled;
+        ar & ch.shadow_period;
+        ar & ch.sweep_timer;
+    }
+}
\ No newline at end of file
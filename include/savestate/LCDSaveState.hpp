@@ -10,9 +10,7 @@
 
 /* Represents the state of a `LCD` object. */
 struct LCDSaveState {
-    // window is reconstructed
-    // renderer is reconstructed
-    // pixel_matrix_texture is reconstructed
+    // sink is not saved
 
     LCD::pixel_buffer_t pixel_buffer;
     ptrdiff_t buffer_it;
@@ -8,7 +8,8 @@
 #include <boost/archive/binary_iarchive.hpp>
 
 
-/* Represents the state of a `MemorySTUB` object. */
+/* Represents the state of a memory stub, the placeholder of the audio registers (before version 1) and the serial
+   port (before version 2) in savestates. */
 struct MemorySTUBSaveState {
     std::string name_;
     RAMSaveState base;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
+
+/* Represents the state of a `Serial` object. The sink is not saved. */
+struct SerialSaveState {
+    uint8_t SB_;
+    uint8_t SC_;
+    uint8_t outgoing;
+    uint8_t bits_left;
+    uint16_t shift_cycles;
+
+    private:
+    friend class boost::serialization::access;
+
+    template<class Archive>
+    void serialize(Archive & ar, [[maybe_unused]] const unsigned int version)
+    {
+        ar & SB_;
+        ar & SC_;
+        ar & outgoing;
+        ar & bits_left;
+        ar & shift_cycles;
+    }
+};
\ No newline at end of file
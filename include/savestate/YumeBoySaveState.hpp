@@ -1,14 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 
+#include <savestate/APUSaveState.hpp>
 #include <savestate/CPUSaveState.hpp>
 #include <savestate/CartridgeSaveState.hpp>
 #include <savestate/PPUSaveState.hpp>
 #include <savestate/LCDSaveState.hpp>
 #include <savestate/MemorySTUBSaveState.hpp>
 #include <savestate/RAMSaveState.hpp>
+#include <savestate/SerialSaveState.hpp>
 #include <savestate/JoypadSaveState.hpp>
 #include <savestate/TimerSaveState.hpp>
 #include <savestate/DMASaveState.hpp>
@@ -16,6 +19,7 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/serialization/unique_ptr.hpp>
+#include <boost/serialization/version.hpp>
 
 /* Represents the state of a `YumeBoy` object. The goal of these separate state structs is to achieve a tree-like hierachy for easy serialization. */
 struct YumeBoySaveState {
@@ -27,10 +31,10 @@ struct YumeBoySaveState {
     CartridgeSaveState cartridge_;
     PPUSaveState ppu_;
     LCDSaveState lcd_;
-    MemorySTUBSaveState audio_;
+    APUSaveState apu_;
     RAMSaveState hram_;
     RAMSaveState wram_;
-    MemorySTUBSaveState link_cable_;
+    SerialSaveState serial_;
     JoypadSaveState joypad_;
     TimerSaveState timer_;
     // InterruptBus has no state
@@ -50,12 +54,34 @@ struct YumeBoySaveState {
         ar & cartridge_;
         ar & ppu_;
         ar & lcd_;
-        ar & audio_;
+        if (version >= 1) {
+            ar & apu_;
+        } else {
+            // the audio registers used to be a memory stub, the APU starts over from the saved registers
+            MemorySTUBSaveState audio_;
+            ar & audio_;
+            apu_ = {};
+            apu_.time_ = ticks;
+            std::ranges::copy(audio_.base.memory_, apu_.registers_.begin());
+            apu_.applied_ = apu_.registers_;
+            apu_.next_sample = ticks;
+        }
         ar & hram_;
         ar & wram_;
-        ar & link_cable_;
+        if (version >= 2) {
+            ar & serial_;
+        } else {
+            // the serial port used to be a memory stub, a requested transfer starts over
+            MemorySTUBSaveState link_cable_;
+            ar & link_cable_;
+            uint8_t SC = link_cable_.base.memory_[1] & 0b10000001;
+            bool transferring = SC == 0b10000001;
+            serial_ = { link_cable_.base.memory_[0], SC, link_cable_.base.memory_[0], uint8_t(transferring ? 8 : 0), uint16_t(transferring ? 512 : 0) };
+        }
         ar & joypad_;
         ar & timer_;
         ar & dma_;
     }
-};
\ No newline at end of file
+};
+
+BOOST_CLASS_VERSION(YumeBoySaveState, 2)
\ No newline at end of file
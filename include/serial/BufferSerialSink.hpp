@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "serial/SerialSink.hpp"
+
+
+/** Keeps the bytes sent over the serial port in memory, e.g. to check the output of a test ROM. */
+class BufferSerialSink : public SerialSink {
+    std::string text_;
+
+    public:
+    void receive(uint8_t byte) override { text_.push_back(char(byte)); }
+
+    /* All bytes received so far. */
+    const std::string &text() const { return text_; }
+
+    bool contains(std::string_view text) const { return text_.find(text) != std::string::npos; }
+
+    void clear() { text_.clear(); }
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "serial/SerialSink.hpp"
+
+
+/** Passes the bytes sent over the serial port on to a function. */
+class CallbackSerialSink : public SerialSink {
+    std::function<void(uint8_t)> callback_;
+
+    public:
+    explicit CallbackSerialSink(std::function<void(uint8_t)> callback) : callback_(std::move(callback)) { }
+
+    void receive(uint8_t byte) override { callback_(byte); }
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "serial/SerialSink.hpp"
+
+
+/** Writes the bytes sent over the serial port to a file (e.g. /dev/stdout), every line is flushed as soon as it is
+ * complete. */
+class FileSerialSink : public SerialSink {
+    std::ofstream file_;
+
+    public:
+    explicit FileSerialSink(const std::string &path) : file_(path, std::ios::binary)
+    {
+        if (not file_.is_open())
+            throw std::runtime_error(std::format("Unable to open {} for the serial output!", path));
+    }
+
+    void receive(uint8_t byte) override
+    {
+        file_.put(char(byte));
+        if (byte == '\n')
+            file_.flush();
+    }
+};
\ No newline at end of file
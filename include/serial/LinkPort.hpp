@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include "apu/RingBuffer.hpp"
+
+
+/** One end of a link cable between two Game Boys that are emulated on different threads (see `LinkCable`). The end is
+ * only used by the thread of its Game Boy, the messages are handed over to the other end without locks. All T-cycles
+ * are those of the Game Boy the end is plugged into, they are converted when they cross the cable. */
+class LinkPort {
+    public:
+    struct Message {
+        enum class TYPE : uint8_t {
+            Transfer,   // the sender started a transfer with its internal clock
+            Reply,      // the byte the receiver of a transfer shifted out in exchange
+        };
+        TYPE type;
+        uint8_t byte;
+        uint64_t t_cycle;   // the T-cycle the transfer completes at
+    };
+
+    private:
+    RingBuffer<Message, 64> outgoing_;  // only written by this end, only read by the other end
+    LinkPort *peer_ = nullptr;
+
+    /* On the cable, T-cycles are counted from the moment both Game Boys were plugged in, which is `origin_` for this end. */
+    uint64_t origin_ = 0;
+    alignas(64) std::atomic<uint64_t> t_cycle_ = 0;     // the T-cycle (on the cable) the Game Boy has been run up to
+    std::atomic<bool> active_ = false;                  // whether the Game Boy is currently run (and receives messages)
+
+    public:
+    /* Plugs the two ends into Game Boys that are at the given T-cycles. */
+    static void connect(LinkPort &first, uint64_t first_t_cycle, LinkPort &second, uint64_t second_t_cycle)
+    {
+        first.peer_ = &second;
+        first.origin_ = first_t_cycle;
+        second.peer_ = &first;
+        second.origin_ = second_t_cycle;
+    }
+
+    uint64_t origin() const { return origin_; }
+
+    /* Sends a message to the other end. If too many messages are in flight, waits until the other end has received some,
+       unless the other Game Boy is not run, then the message is dropped. */
+    void send(Message message)
+    {
+        message.t_cycle -= origin_;
+        while (outgoing_.write({&message, 1}) == 0 and peer_->active())
+            std::this_thread::yield();
+    }
+
+    /* Returns the next message from the other end, nothing if there is none yet. */
+    std::optional<Message> receive()
+    {
+        Message message;
+        if (peer_->outgoing_.read({&message, 1}) == 0)
+            return std::nullopt;
+        message.t_cycle += origin_;
+        return message;
+    }
+
+    /* Tells the other end that the Game Boy has been run up to the given T-cycle. */
+    void publish(uint64_t t_cycle) { t_cycle_.store(t_cycle - origin_, std::memory_order_release); }
+
+    /* The T-cycle (of this Game Boy) the other Game Boy has been run up to. */
+    uint64_t peer_t_cycle() const { return peer_->t_cycle_.load(std::memory_order_acquire) + origin_; }
+
+    bool active() const { return active_.load(std::memory_order_acquire); }
+    void active(bool active) { active_.store(active, std::memory_order_release); }
+    bool peer_active() const { return peer_->active(); }
+};
\ No newline at end of file
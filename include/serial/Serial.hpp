@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <cpu/InterruptBus.hpp>
+#include <mmu/Memory.hpp>
+#include "serial/LinkPort.hpp"
+#include "serial/SerialSink.hpp"
+
+
+struct SerialSaveState;
+
+/** The serial port the link cable is plugged into. Without a cable, every bit received is 1. With a `LinkPort` plugged
+ * in, the bytes are exchanged with another Game Boy (see `LinkCable`). The bytes sent are passed on to a `SerialSink`. */
+class Serial : public Memory {
+    const uint64_t &synced_ticks;   // the T-cycle the serial port has been run up to (see `YumeBoy`)
+    InterruptBus &interrupts;
+    std::unique_ptr<SerialSink> sink;
+    LinkPort *link = nullptr;
+
+    /* 0xFF01 — SB: Serial transfer data
+       Before a transfer, it holds the next byte that will go out. During a transfer, it has a blend of the outgoing and
+       incoming bytes. Each cycle, the leftmost bit is shifted out (and over the wire) and the incoming bit is shifted in
+       from the other side. */
+    uint8_t SB_ = 0x0;
+
+    /* 0xFF02 — SC: Serial transfer control
+       Bit 7 - Transfer enable: If 1, a transfer is either requested or in progress.
+       Bit 0 - Clock select: If 1, the Game Boy drives the clock (internal clock) at 8192 Hz, otherwise it waits for the
+               clock of the other side (external clock), which never comes since nothing is plugged in.
+       (https://gbdev.io/pandocs/Serial_Data_Transfer_(Link_Cable).html) */
+    uint8_t SC_ = 0x0;
+
+    uint8_t outgoing = 0x0;     // the byte that is sent by the current transfer
+    uint8_t bits_left = 0;      // the bits of the current transfer (with the internal clock) that are not shifted yet
+    uint16_t shift_cycles = 0;  // T-cycles until the next bit is shifted
+
+    /* A transfer the other Game Boy started with its internal clock, which drives this serial port as external clock. */
+    struct Incoming {
+        uint64_t t_cycle;   // the T-cycle the transfer completes at
+        uint8_t byte;
+        bool late;          // received after it should have completed (see `LinkCable`)
+        uint64_t deadline;  // the T-cycle a late transfer stops waiting for a transfer with the external clock
+    };
+    std::optional<Incoming> incoming;
+    std::optional<LinkPort::Message> reply;     // the latest byte the other Game Boy sent back for a transfer
+    std::optional<uint64_t> awaited_reply;      // the T-cycle of a transfer that is over, but whose reply has not arrived
+
+    /* Shifts out the next bit at the given T-cycle, the transfer completes with the last one. */
+    void shift(uint64_t t_cycle);
+
+    /* Ends the current transfer, `SB` holds the byte received. */
+    void complete_transfer();
+
+    /* Completes the incoming transfer: if a transfer with the external clock is requested, the bytes are exchanged.
+       Otherwise nothing is shifted, unless the transfer is late, then it waits for one to be requested, for the length
+       of a transfer at most and only as long as no transfer with the internal clock is in progress. */
+    void complete_incoming();
+
+    /* Waits until the other Game Boy has run up to the end of the transfer that completes at the given T-cycle and
+       returns the byte it sent back, nothing if it was ahead and the byte has not arrived yet. */
+    std::optional<uint8_t> wait_for_reply(uint64_t t_cycle);
+
+    /* Receives the messages from the other Game Boy at the given T-cycle. */
+    void poll_link(uint64_t t_cycle);
+
+    public:
+    static constexpr uint16_t BIT_T_CYCLES = 512;  // the internal clock runs at 8192 Hz
+
+    Serial() = delete;
+    /* Without a sink, the bytes sent are dropped. */
+    Serial(const uint64_t &synced_ticks, InterruptBus &interrupts, std::unique_ptr<SerialSink> sink)
+        : synced_ticks(synced_ticks), interrupts(interrupts), sink(std::move(sink)) { }
+
+    /* Advance the Serial state by a single T-Cycle. */
+    void tick() { tick(1); }
+
+    /* Advance the Serial state by the given number of T-Cycles. */
+    void tick(uint32_t t_cycles);
+
+    /* Returns the T-Cycles until the serial interrupt is requested (or an incoming transfer completes), nothing if no
+       transfer is in progress. */
+    std::optional<uint32_t> cycles_until_interrupt() const;
+
+    /* Plugs in one end of a link cable, unplugs the cable if null. */
+    void connect(LinkPort *port);
+
+    /* Receives the messages from the other Game Boy. While the emulation runs, they are only received when waiting for
+       a reply, so this is called in between (see `LinkCable`). */
+    void poll_link() { if (link) poll_link(synced_ticks); }
+
+    bool contains_address(uint16_t addr) const override;
+    uint8_t read_memory(uint16_t addr) override;
+    void write_memory(uint16_t addr, uint8_t value) override;
+
+    SerialSaveState save_state() const;
+    void load_state(SerialSaveState state);
+};
\ No newline at end of file
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+
+/** Receives the bytes the Game Boy sends over the serial port, e.g. the results test ROMs print. */
+class SerialSink {
+    public:
+    virtual ~SerialSink() = default;
+
+    /* Called on the emulation thread whenever a transfer has completed with the byte that was sent. */
+    virtual void receive(uint8_t byte) = 0;
+};
\ No newline at end of file
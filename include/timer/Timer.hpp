@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <cpu/InterruptBus.hpp>
 #include <mmu/Memory.hpp>
 
@@ -21,6 +22,12 @@ class Timer : public Memory {
 
     bool old_tac_bit = false;   // Implements the "delay" in the DIV & TAC falling edge detector.
 
+    /* Returns the bit of the system counter selected by the TAC multiplexer. */
+    uint8_t selected_bit() const;
+
+    /* Returns the output of the TAC multiplexer, i.e. the selected bit of the system counter if the timer is enabled. */
+    bool tac_bit() const;
+
     /* 0xFF05 - TIMA: Timer counter
     This timer is incremented at the clock frequency specified by the TAC register (0xFF07). When the value overflows (exceeds 0xFF) it is reset to the value specified in TMA (0xFF06) and an interrupt is requested. */
     uint8_t TIMA_ = 0x0;
@@ -59,6 +66,14 @@ class Timer : public Memory {
     /* Advance the Timer state by a single T-Cycle. */
     void tick();
 
+    /* Advance the Timer state by the given number of T-Cycles. TIMA is computed arithmetically from the number of
+       falling edges of the selected system counter bit instead of running the falling edge detector every T-Cycle. */
+    void tick(uint32_t t_cycles);
+
+    /* Returns the T-Cycles until the timer interrupt is requested, nothing if the timer is stopped.
+       Writing a timer register changes the result. Directly after a DIV or TAC write, 1 is returned. */
+    std::optional<uint32_t> cycles_until_interrupt() const;
+
     bool contains_address(uint16_t addr) const override;
     uint8_t read_memory(uint16_t addr) override;
     void write_memory(uint16_t addr, uint8_t value) override;
@@ -0,0 +1,401 @@
+#include "apu/APU.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <savestate/APUSaveState.hpp>
+
+
+namespace {
+    /* The waveforms of the duty cycles 12.5%, 25%, 50% and 75%, one bit per step. */
+    constexpr std::array<uint8_t, 4> DUTY_CYCLES = { 0b00000001, 0b10000001, 0b10000111, 0b01111110 };
+
+    /* The bits that read back as 1, the registers are partially write-only. */
+    constexpr std::array<uint8_t, 0x17> READ_MASKS = {
+        0x80, 0x3F, 0x00, 0xFF, 0xBF,   // NR10-NR14
+        0xFF, 0x3F, 0x00, 0xFF, 0xBF,   // unused, NR21-NR24
+        0x7F, 0xFF, 0x9F, 0xFF, 0xBF,   // NR30-NR34
+        0xFF, 0xFF, 0x00, 0x00, 0xBF,   // unused, NR41-NR44
+        0x00, 0x00, 0x70,               // NR50-NR52
+    };
+}
+
+uint16_t APU::period(uint8_t channel) const
+{
+    assert(channel < 3);
+    const uint16_t NRx3 = std::array<uint16_t, 3>{ NR13, NR23, NR33 }[channel];
+    return reg(NRx3) | ((reg(NRx3 + 1) & 0b111) << 8);
+}
+
+int32_t APU::step_t_cycles(uint8_t channel) const
+{
+    switch (channel)
+    {
+    case 0:
+    case 1:
+        return (2048 - period(channel)) * 4;
+    case 2:
+        return (2048 - period(channel)) * 2;
+    case 3:
+    {
+        // a shift of 14 or 15 stops the LFSR, which is handled by `advance`
+        uint8_t divider = reg(NR43) & 0b111;
+        return (divider == 0 ? 8 : divider * 16) << (reg(NR43) >> 4);
+    }
+    default:
+        std::unreachable();
+    }
+}
+
+uint8_t APU::read_memory(uint16_t addr)
+{
+    assert(contains_address(addr));
+    if (addr >= WAVE_RAM)
+        return registers_[addr - REG_BEGIN];
+    if (addr > NR52)
+        return 0xFF;
+
+    if (addr == NR52)
+    {
+        // the channels may have been turned off by their length timers in the meantime
+        synthesize();
+        uint8_t status = 0;
+        for (uint8_t i = 0; i < 4; ++i)
+            status |= uint8_t(channels[i].enabled) << i;
+        return (registers_[NR52 - REG_BEGIN] & 0x80) | READ_MASKS[NR52 - REG_BEGIN] | status;
+    }
+    return registers_[addr - REG_BEGIN] | READ_MASKS[addr - REG_BEGIN];
+}
+
+void APU::write_memory(uint16_t addr, uint8_t value)
+{
+    assert(contains_address(addr));
+    bool powered = registers_[NR52 - REG_BEGIN] & 0x80;
+    if (addr < WAVE_RAM and addr != NR52 and not powered)
+        return; // the registers cannot be written while the APU is turned off
+
+    if (addr == NR52)
+    {
+        // turning the APU on or off resets registers, which has to be visible immediately
+        synthesize();
+        apply(addr, value);
+        registers_ = applied_;
+        return;
+    }
+
+    registers_[addr - REG_BEGIN] = value;
+    pending_writes.push_back({ std::max(clock_, time_), addr, value });
+}
+
+void APU::apply(uint16_t addr, uint8_t value)
+{
+    if (addr == NR52)
+    {
+        if (not (value & 0x80))
+        {
+            // turning the APU off clears all registers (except wave RAM) and stops all channels
+            std::fill(applied_.begin(), applied_.begin() + (NR52 - REG_BEGIN), 0);
+            channels = {};
+        }
+        else if (not (reg(NR52) & 0x80))
+            frame_sequencer_step = 0;
+        reg(NR52) = value & 0x80;
+        return;
+    }
+
+    reg(addr) = value;
+    switch (addr)
+    {
+    case NR11:
+    case NR21:
+    case NR31:
+    case NR41:
+    {
+        uint8_t channel = (addr - NR11) / 5;
+        channels[channel].length = addr == NR31 ? value : value & 0x3F;
+        break;
+    }
+    case NR12:
+    case NR22:
+    case NR42:
+        // turning off the DAC turns off the channel
+        if ((value & 0xF8) == 0)
+            channels[(addr - NR12) / 5].enabled = false;
+        break;
+    case NR30:
+        if (not (value & 0x80))
+            channels[2].enabled = false;
+        break;
+    case NR14:
+    case NR24:
+    case NR34:
+    case NR44:
+    {
+        uint8_t channel = (addr - NR14) / 5;
+        channels[channel].length_enabled = value & 0x40;
+        if (value & 0x80)
+            trigger(channel);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void APU::trigger(uint8_t channel)
+{
+    Channel &ch = channels[channel];
+    const uint16_t NRx2 = NR12 + 5 * channel;
+    bool dac = channel == 2 ? reg(NR30) & 0x80 : reg(NRx2) & 0xF8;
+    ch.enabled = dac;
+
+    if (ch.length == (channel == 2 ? 256 : 64))
+        ch.length = 0;
+    ch.timer = step_t_cycles(channel);
+
+    switch (channel)
+    {
+    case 0:
+        ch.shadow_period = period(0);
+        ch.sweep_timer = (reg(NR10) >> 4) & 0b111;
+        if (ch.sweep_timer == 0) ch.sweep_timer = 8;
+        ch.sweep_enabled = reg(NR10) & 0x77;
+        if (reg(NR10) & 0b111)
+            sweep_period();
+        [[fallthrough]];
+    case 1:
+    case 3:
+        ch.volume = reg(NRx2) >> 4;
+        ch.envelope_timer = reg(NRx2) & 0b111;
+        if (channel == 3)
+            ch.lfsr = 0x7FFF;
+        break;
+    case 2:
+        ch.step = 0;
+        break;
+    default:
+        std::unreachable();
+    }
+}
+
+void APU::clock_length(Channel &ch)
+{
+    uint16_t max = &ch == &channels[2] ? 256 : 64;
+    if (ch.length_enabled and ch.length < max and ++ch.length == max)
+        ch.enabled = false;
+}
+
+void APU::clock_envelope(Channel &ch, uint8_t NRx2)
+{
+    uint8_t pace = NRx2 & 0b111;
+    if (pace == 0 or --ch.envelope_timer != 0)
+        return;
+    ch.envelope_timer = pace;
+
+    if (NRx2 & 0x08 and ch.volume < 15)
+        ++ch.volume;
+    else if (not (NRx2 & 0x08) and ch.volume > 0)
+        --ch.volume;
+}
+
+uint16_t APU::sweep_period()
+{
+    Channel &ch = channels[0];
+    uint16_t delta = ch.shadow_period >> (reg(NR10) & 0b111);
+    uint16_t next = reg(NR10) & 0x08 ? ch.shadow_period - delta : ch.shadow_period + delta;
+    if (next > 2047)
+        ch.enabled = false;
+    return next;
+}
+
+void APU::clock_sweep()
+{
+    Channel &ch = channels[0];
+    if (--ch.sweep_timer != 0)
+        return;
+    uint8_t pace = (reg(NR10) >> 4) & 0b111;
+    ch.sweep_timer = pace == 0 ? 8 : pace;
+
+    if (not ch.sweep_enabled or pace == 0)
+        return;
+    uint16_t next = sweep_period();
+    if (next <= 2047 and (reg(NR10) & 0b111))
+    {
+        ch.shadow_period = next;
+        reg(NR13) = next & 0xFF;
+        reg(NR14) = (reg(NR14) & ~0b111) | (next >> 8);
+        sweep_period();
+    }
+}
+
+void APU::clock_frame_sequencer()
+{
+    // lengths are clocked at 256 Hz, the sweep at 128 Hz and the envelopes at 64 Hz
+    if (frame_sequencer_step % 2 == 0)
+        for (Channel &ch : channels)
+            clock_length(ch);
+    if (frame_sequencer_step % 4 == 2)
+        clock_sweep();
+    if (frame_sequencer_step == 7)
+    {
+        clock_envelope(channels[0], reg(NR12));
+        clock_envelope(channels[1], reg(NR22));
+        clock_envelope(channels[3], reg(NR42));
+    }
+    frame_sequencer_step = (frame_sequencer_step + 1) % 8;
+}
+
+void APU::advance(uint32_t t_cycles)
+{
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        Channel &ch = channels[i];
+        if (not ch.enabled)
+            continue;
+
+        ch.timer -= int32_t(t_cycles);
+        if (ch.timer > 0)
+            continue;
+
+        const int32_t period = step_t_cycles(i);
+        const uint32_t steps = 1 + uint32_t(-ch.timer) / uint32_t(period);
+        ch.timer += int32_t(steps) * period;
+
+        if (i == 3)
+        {
+            if ((reg(NR43) >> 4) >= 14)
+                continue;
+            for (uint32_t s = 0; s < steps; ++s)
+            {
+                uint16_t bit = (ch.lfsr ^ (ch.lfsr >> 1)) & 1;
+                ch.lfsr = (ch.lfsr >> 1) | (bit << 14);
+                if (reg(NR43) & 0x08)
+                    ch.lfsr = (ch.lfsr & ~(1 << 6)) | (bit << 6);
+            }
+        }
+        else
+            ch.step = uint8_t((ch.step + steps) % (i == 2 ? 32 : 8));
+    }
+}
+
+int APU::output(uint8_t channel) const
+{
+    const Channel &ch = channels[channel];
+    switch (channel)
+    {
+    case 0:
+    case 1:
+        if (not (reg(NR12 + 5 * channel) & 0xF8)) return -1;
+        return ch.enabled and DUTY_CYCLES[reg(NR11 + 5 * channel) >> 6] >> ch.step & 1 ? ch.volume : 0;
+    case 2:
+    {
+        if (not (reg(NR30) & 0x80)) return -1;
+        if (not ch.enabled) return 0;
+        uint8_t sample = reg(WAVE_RAM + ch.step / 2) >> (ch.step % 2 == 0 ? 4 : 0) & 0xF;
+        uint8_t level = (reg(NR32) >> 5) & 0b11;
+        return level == 0 ? 0 : sample >> (level - 1);
+    }
+    case 3:
+        if (not (reg(NR42) & 0xF8)) return -1;
+        return ch.enabled and not (ch.lfsr & 1) ? ch.volume : 0;
+    default:
+        std::unreachable();
+    }
+}
+
+void APU::mix()
+{
+    std::array<float, 2> out{};
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        int digital = output(i);
+        if (digital < 0) continue;  // the DAC is turned off
+        // the DAC maps 0-15 linearly to 1 to -1
+        float analog = 1.0f - float(digital) / 7.5f;
+        if (reg(NR51) & (1 << (i + 4))) out[0] += analog;
+        if (reg(NR51) & (1 << i)) out[1] += analog;
+    }
+
+    // the master volume scales from 1/8 to 8/8, the four channels make up at most 4
+    out[0] *= float(((reg(NR50) >> 4) & 0b111) + 1) / 32.0f;
+    out[1] *= float((reg(NR50) & 0b111) + 1) / 32.0f;
+
+    for (uint8_t side = 0; side < 2; ++side)
+    {
+        float filtered = out[side] - high_pass_charge[side];
+        high_pass_charge[side] = out[side] - filtered * 0.996f;
+        samples_.push_back(int16_t(std::clamp(filtered, -1.0f, 1.0f) * 32767.0f));
+    }
+}
+
+void APU::synthesize(uint64_t until)
+{
+    auto write = pending_writes.begin();
+    while (time_ < until)
+    {
+        // run up to the next event: a recorded write, a frame sequencer step or a sample
+        uint64_t next_step = (time_ / FRAME_SEQUENCER_T_CYCLES + 1) * FRAME_SEQUENCER_T_CYCLES;
+        uint64_t next = std::min({ until, next_step, next_sample });
+        if (write != pending_writes.end())
+            next = std::min(next, std::max(write->time, time_));
+
+        advance(uint32_t(next - time_));
+        time_ = next;
+
+        for (; write != pending_writes.end() and write->time <= time_; ++write)
+            apply(write->addr, write->value);
+        if (time_ == next_step and reg(NR52) & 0x80)
+            clock_frame_sequencer();
+        if (time_ == next_sample)
+        {
+            if (sink)
+                mix();
+            next_sample += CLOCK_RATE / SAMPLE_RATE;
+            sample_remainder += CLOCK_RATE % SAMPLE_RATE;
+            if (sample_remainder >= SAMPLE_RATE) {
+                sample_remainder -= SAMPLE_RATE;
+                ++next_sample;
+            }
+        }
+    }
+
+    // the writes in the T-cycle the synthesis stopped at
+    for (; write != pending_writes.end() and write->time <= until; ++write)
+        apply(write->addr, write->value);
+    pending_writes.erase(pending_writes.begin(), write);
+
+    if (not samples_.empty()) {
+        sink->push(samples_);
+        samples_.clear();
+    }
+}
+
+APUSaveState APU::save_state()
+{
+    synthesize();
+    assert(pending_writes.empty());
+
+    APUSaveState s = {
+        time_,
+        registers_,
+        applied_,
+        channels,
+        frame_sequencer_step,
+        next_sample,
+        sample_remainder,
+        high_pass_charge,
+    };
+    return s;
+}
+
+void APU::load_state(APUSaveState state)
+{
+    time_ = state.time_;
+    registers_ = state.registers_;
+    applied_ = state.applied_;
+    channels = state.channels;
+    frame_sequencer_step = state.frame_sequencer_step;
+    next_sample = state.next_sample;
+    sample_remainder = state.sample_remainder;
+    high_pass_charge = state.high_pass_charge;
+    pending_writes.clear();
+}
@@ -0,0 +1,65 @@
+#include "apu/SDLAudioSink.hpp"
+
+#include <algorithm>
+#include <array>
+
+
+SDLAudioSink::SDLAudioSink()
+{
+    SDL_Init(SDL_INIT_AUDIO);
+
+    const SDL_AudioSpec spec = { SDL_AUDIO_S16, 2, SAMPLE_RATE };
+    // the device is paused until enough samples have been buffered (see `push`)
+    stream = std::unique_ptr<SDL_AudioStream, sdl_deleter>(SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, feed, this), sdl_deleter());
+}
+
+SDLAudioSink::~SDLAudioSink()
+{
+    // stops the audio callback before the ring buffer is destroyed
+    stream.reset();
+
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+void SDLAudioSink::push(std::span<const int16_t> samples)
+{
+    if (not stream) return; // there is no audio device, the samples are dropped
+
+    if (buffered_samples.write(samples) != samples.size())
+        ++overruns;
+
+    if (not started and buffered_samples.size() >= START_SAMPLES) {
+        started = true;
+        SDL_ResumeAudioStreamDevice(stream.get());
+    }
+}
+
+AudioSink::Counters SDLAudioSink::counters() const
+{
+    return { underruns.load(std::memory_order_relaxed), overruns };
+}
+
+std::optional<double> SDLAudioSink::buffer_fill() const
+{
+    if (not stream) return std::nullopt;
+    return double(buffered_samples.size()) / double(buffered_samples.capacity());
+}
+
+void SDLAudioSink::feed(void *userdata, SDL_AudioStream *stream, int additional_amount, [[maybe_unused]] int total_amount)
+{
+    SDLAudioSink &sink = *static_cast<SDLAudioSink *>(userdata);
+
+    std::array<int16_t, 1024> buffer;
+    size_t needed = size_t(additional_amount) / sizeof(int16_t);
+    while (needed > 0)
+    {
+        size_t count = sink.buffered_samples.read(std::span(buffer).first(std::min(needed, buffer.size())));
+        if (count == 0) break;
+        SDL_PutAudioStreamData(stream, buffer.data(), int(count * sizeof(int16_t)));
+        needed -= count;
+    }
+
+    // SDL plays silence for the samples that are missing
+    if (needed > 0)
+        sink.underruns.fetch_add(1, std::memory_order_relaxed);
+}
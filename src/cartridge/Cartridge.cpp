@@ -26,11 +26,16 @@ constexpr std::array<uint8_t, 256> boot_rom = {
 };
 
 uint8_t Cartridge::rom_bytes(uint32_t addr)
+{
+    return *rom_ptr(addr);
+}
+
+const uint8_t *Cartridge::rom_ptr(uint32_t addr) const
 {
     assert(addr <= rom_bytes_.size());
     if (boot_rom_enabled_ == 0 and addr <= 0xFF)
-        return boot_rom[addr];
-    return rom_bytes_[addr];
+        return &boot_rom[addr];
+    return &rom_bytes_[addr];
 }
 
 uint8_t Cartridge::ram_bytes(uint32_t addr)
@@ -66,6 +71,7 @@ void Cartridge::load_state(CartridgeSaveState state)
     assert(CARTRIDGE_TYPE == state.CARTRIDGE_TYPE);
     assert(ROM_SIZE == state.ROM_SIZE);
     assert(RAM_SIZE == state.RAM_SIZE);
+    remap();
 }
 
 /*==============================================================================================================*/
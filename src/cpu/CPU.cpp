@@ -11,6 +11,14 @@ uint8_t CPU::fetch_byte()
     return byte;
 }
 
+Instruction *CPU::decode(uint8_t opcode, bool extended)
+{
+    Instruction *decoded = instructions_[(extended ? 0x100 : 0x0) | opcode].get();
+    assert(decoded and "Illegal opcode");
+    instruction_state_.cycle = 0;
+    return decoded;
+}
+
 void CPU::tick()
 {
     /* Interrupt Handling */
@@ -35,8 +43,8 @@ void CPU::tick()
             break;
         }
         
-        instruction = Instruction::Get(opcode, false, *this, mem_);
-        if (not instruction->execute()) {
+        instruction = decode(opcode, false);
+        if (not Instruction::Execute(*instruction)) {
             state = CPU_STATES::Execute;
         } else if (EI_executed and not set_IME) {
             set_IME = true;
@@ -51,8 +59,8 @@ void CPU::tick()
     case CPU_STATES::FetchExtOpcode:
     {
         uint8_t opcode = fetch_byte();
-        instruction = Instruction::Get(opcode, true, *this, mem_);
-        if (not instruction->execute()) {
+        instruction = decode(opcode, true);
+        if (not Instruction::Execute(*instruction)) {
             state = CPU_STATES::Execute;
             break;
         } else if (set_IME) {
@@ -67,7 +75,7 @@ void CPU::tick()
 
     case CPU_STATES::Execute:
     {
-        if (instruction->execute()) {
+        if (Instruction::Execute(*instruction)) {
             state = CPU_STATES::FetchOpcode;
             if (set_IME) {
                 assert (EI_executed);
@@ -168,7 +176,8 @@ void CPU::load_state(CPUSaveState cpu_state)
 {
     state = cpu_state.state;
 
-    instruction = instruction->load_state(cpu_state.instruction, *this, mem_);
+    instruction = instructions_[(cpu_state.instruction.extended ? 0x100 : 0x0) | cpu_state.instruction.opcode].get();
+    instruction->load_state(cpu_state.instruction);
 
     A = cpu_state.A;
     B = cpu_state.B;
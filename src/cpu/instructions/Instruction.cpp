@@ -1,6 +1,7 @@
 #include <cpu/instructions/Instruction.hpp>
 
 #include "cpu/CPU.hpp"
+#include <array>
 #include <cstdint>
 #include <utility>
 #include "YumeBoy.hpp"
@@ -29,13 +30,55 @@ std::unique_ptr<Instruction> Instruction::Get(uint8_t opcode, bool extended, CPU
         #include "cpu/instructions/opcodes.tbl"
         
         default:
-            std::unreachable();
+            // illegal opcodes (and the 0xCB prefix) have no instruction
+            break;
         }
     }
     return instruction;
 }
 #undef INSTRUCTION
 
+#if defined(YUMEBOY_DISPATCH_TABLE)
+
+/* Devirtualizes the call of `execute()`: the free functions call it non-virtually, which allows the compiler to inline
+   the instruction into them. */
+#define INSTRUCTION(op, name, _) \
+static bool execute_##name(Instruction &instruction) { return static_cast<name &>(instruction).name::execute(); }
+#include "cpu/instructions/opcodes.tbl"
+#include "cpu/instructions/extended_opcodes.tbl"
+#undef INSTRUCTION
+
+static bool execute_illegal([[maybe_unused]] Instruction &instruction)
+{
+    std::unreachable();
+}
+
+static constexpr auto dispatch_table = [] {
+    std::array<bool (*)(Instruction &), 0x200> table;
+    table.fill(&execute_illegal);
+    #define INSTRUCTION(op, name, _) table[op] = &execute_##name;
+    #include "cpu/instructions/opcodes.tbl"
+    #undef INSTRUCTION
+    #define INSTRUCTION(op, name, _) table[0x100 | op] = &execute_##name;
+    #include "cpu/instructions/extended_opcodes.tbl"
+    #undef INSTRUCTION
+    return table;
+}();
+
+bool Instruction::Execute(Instruction &instruction)
+{
+    return dispatch_table[instruction.index()](instruction);
+}
+
+#else
+
+bool Instruction::Execute(Instruction &instruction)
+{
+    return instruction.execute();
+}
+
+#endif
+
 //=================================================================================================//
 //  HELPER FUNCTIONS                                                                               //
 //=================================================================================================//
@@ -249,6 +292,13 @@ bool Instruction::SET(uint8_t bit, uint8_t &R) const
     return true;
 }
 
+MultiCycleInstruction::MultiCycleInstruction(CPU &cpu, MMU &mem, uint8_t opcode, bool extended)
+    : Instruction(cpu, mem, opcode, extended),
+      cycle_(cpu.instruction_state_.cycle),
+      temp_u8(cpu.instruction_state_.temp_u8),
+      temp_u16(cpu.instruction_state_.temp_u16)
+{ }
+
 bool MultiCycleInstruction::LD_R16_D16(uint8_t &higher_R, uint8_t &lower_R)
 {
     switch (next_cycle()) {
@@ -4615,13 +4665,9 @@ InstructionSaveState MultiCycleInstruction::save_state()
     return s;
 }
 
-std::unique_ptr<Instruction> Instruction::load_state(InstructionSaveState state, CPU &cpu, MMU& mem)
+void MultiCycleInstruction::load_state(const InstructionSaveState &state)
 {
-    auto instr = Get(state.opcode, state.extended, cpu, mem);
-    if (auto mc_instr = dynamic_cast<MultiCycleInstruction*>(instr.get())) {
-        mc_instr->cycle_ = state.cycle;
-        mc_instr->temp_u8 = state.temp_u8;
-        mc_instr->temp_u16 = state.temp_u16;
-    }
-    return instr;
+    cycle_ = state.cycle;
+    temp_u8 = state.temp_u8;
+    temp_u16 = state.temp_u16;
 }
\ No newline at end of file
@@ -1,7 +1,5 @@
 #include "joypad/Joypad.hpp"
 
-#include "YumeBoy.hpp"
-#include "SDL3/SDL_events.h"
 #include <savestate/JoypadSaveState.hpp>
 
 uint8_t Joypad::P1() const
@@ -34,91 +32,26 @@ void Joypad::P1(uint8_t value)
         interrupts.request_interrupt(InterruptBus::INTERRUPT::JOYPAD_INTERRUPT);
 }
 
-void Joypad::update_joypad_state()
+void Joypad::buttons(const Buttons &buttons)
 {
-    SDL_Event event;
+    uint8_t P1_ = P1();
+    bool old_combined_input_lines = (P1_ & 0b1000) and (P1_ & 0b0100) and (P1_ & 0b0010) and (P1_ & 0b0001);
 
-    while (SDL_PollEvent(&event))
-    {
-        switch (event.type)
-        {
-            case SDL_EVENT_KEY_DOWN: {
-                
-                switch (event.key.scancode)
-                {
-#ifndef NDEBUG
-                case SDL_SCANCODE_1:
-                    yume_boy_.dump_tilemap();
-                    break;
-                
-                case SDL_SCANCODE_2:
-                    yume_boy_.screenshot();
-                    break;
-                
-                case SDL_SCANCODE_3:
-                    yume_boy_.save_state();
-                    break;
-                
-                case SDL_SCANCODE_4:
-                    yume_boy_.load_state();
-                    break;
-#endif
-                default:
-                    break;
-                }
-            } // do not break in outer switch block
-            case SDL_EVENT_KEY_UP: {
-                uint8_t P1_ = P1();
-                bool old_combined_input_lines = (P1_ & 0b1000) and (P1_ & 0b0100) and (P1_ & 0b0010) and (P1_ & 0b0001);
+    state_.start_button = buttons.start;
+    state_.select_button = buttons.select;
+    state_.b_button = buttons.b;
+    state_.a_button = buttons.a;
 
-                switch (event.key.scancode)
-                {
-                case SDL_SCANCODE_Z:
-                    state_.b_button = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_X:
-                    state_.a_button = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_RETURN:
-                    state_.start_button = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_BACKSPACE:
-                    state_.select_button = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_DOWN:
-                    state_.down_dpad = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_UP:
-                    state_.up_dpad = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_LEFT:
-                    state_.left_dpad = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                case SDL_SCANCODE_RIGHT:
-                    state_.right_dpad = event.type == SDL_EVENT_KEY_DOWN;
-                    break;
-                
-                default:
-                    break;
-                }
-                // Falling edge detector
-                P1_ = P1();
-                if (bool new_combined_input_lines = (P1_ & 0b1000) and (P1_ & 0b0100) and (P1_ & 0b0010) and (P1_ & 0b0001); old_combined_input_lines and not new_combined_input_lines)
-                    interrupts.request_interrupt(InterruptBus::INTERRUPT::JOYPAD_INTERRUPT);
-                break;
-            }
+    state_.down_dpad = buttons.down;
+    state_.up_dpad = buttons.up;
+    state_.left_dpad = buttons.left;
+    state_.right_dpad = buttons.right;
 
-            default:
-                break;
-        }
-    }
+    // Falling edge detector
+    P1_ = P1();
+    bool new_combined_input_lines = (P1_ & 0b1000) and (P1_ & 0b0100) and (P1_ & 0b0010) and (P1_ & 0b0001);
+    if (old_combined_input_lines and not new_combined_input_lines)
+        interrupts.request_interrupt(InterruptBus::INTERRUPT::JOYPAD_INTERRUPT);
 }
 
 JoypadSaveState Joypad::save_state() const {
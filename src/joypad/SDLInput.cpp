@@ -0,0 +1,130 @@
+#include "joypad/SDLInput.hpp"
+
+#include <iostream>
+#include <SDL3/SDL.h>
+
+void SDLInput::poll()
+{
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event))
+    {
+        switch (event.type)
+        {
+            case SDL_EVENT_KEY_DOWN: {
+
+                switch (event.key.scancode)
+                {
+#ifndef NDEBUG
+                case SDL_SCANCODE_1:
+                    hotkeys_ |= DUMP_TILEMAP;
+                    break;
+
+                case SDL_SCANCODE_2:
+                    hotkeys_ |= SCREENSHOT;
+                    break;
+
+                case SDL_SCANCODE_3:
+                    hotkeys_ |= SAVE_STATE;
+                    break;
+
+                case SDL_SCANCODE_4:
+                    hotkeys_ |= LOAD_STATE;
+                    break;
+#endif
+                default:
+                    break;
+                }
+            } // do not break in outer switch block
+                [[fallthrough]];
+            case SDL_EVENT_KEY_UP: {
+                switch (event.key.scancode)
+                {
+                case SDL_SCANCODE_Z:
+                    buttons_.b = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_X:
+                    buttons_.a = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_RETURN:
+                    buttons_.start = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_BACKSPACE:
+                    buttons_.select = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_DOWN:
+                    buttons_.down = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_UP:
+                    buttons_.up = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_LEFT:
+                    buttons_.left = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                case SDL_SCANCODE_RIGHT:
+                    buttons_.right = event.type == SDL_EVENT_KEY_DOWN;
+                    break;
+
+                default:
+                    break;
+                }
+                break;
+            }
+
+            case SDL_EVENT_QUIT:
+                quit_requested_ = true;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    pending_buttons_.store(buttons_, std::memory_order_relaxed);
+}
+
+void SDLInput::apply()
+{
+    core_.set_input(pending_buttons_.load(std::memory_order_relaxed));
+
+#ifndef NDEBUG
+    uint8_t hotkeys = hotkeys_.exchange(0, std::memory_order_relaxed);
+    if (hotkeys & DUMP_TILEMAP)
+        core_.yume_boy().dump_tilemap();
+    if (hotkeys & SCREENSHOT)
+        screenshot("screenshot.bmp");
+    if (hotkeys & SAVE_STATE)
+        core_.yume_boy().save_state();
+    if (hotkeys & LOAD_STATE)
+        core_.yume_boy().load_state();
+#endif
+}
+
+#ifndef NDEBUG
+bool SDLInput::screenshot(const char *fileName) const
+{
+    const YumeBoyCore::Frame &frame = core_.framebuffer();
+    SDL_Surface* surface = SDL_CreateSurfaceFrom(VideoSink::WIDTH, VideoSink::HEIGHT, SDL_PIXELFORMAT_RGBA32, const_cast<uint8_t *>(frame.data()), VideoSink::WIDTH * sizeof(uint8_t) * 4);
+    if (not surface) {
+        std::cerr << "Failed to create surface: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Save the surface as a BMP file
+    if (SDL_SaveBMP(surface, fileName) != 0) {
+        std::cerr << "Failed to save BMP: " << SDL_GetError() << std::endl;
+    }
+
+    // Clean up
+    SDL_DestroySurface(surface);
+
+    return true;
+}
+#endif
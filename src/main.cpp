@@ -1,23 +1,222 @@
-#include "YumeBoy.hpp"
-
-
-int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[]) {
-    std::string rom_path = "../Tetris (World) (Rev 1).gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/cpu_instrs.gb", true;
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/01-special.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/02-interrupts.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/03-op sp,hl.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/04-op r,imm.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/05-op rp.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/06-ld r,r.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/07-jr,jp,call,ret,rst.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/08-misc instrs.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/09-op r,r.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/10-bit ops.gb";
-    // std::string rom_path = "../gb-test-roms/cpu_instrs/individual/11-op a,(hl).gb";
-    // std::string rom_path = "../gb-test-roms/instr_timing/instr_timing.gb";
-    YumeBoy yume_boy(rom_path, false);
-    while (true)
-        yume_boy.tick();
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <SDL3/SDL.h>
+#include "apu/SDLAudioSink.hpp"
+#include "joypad/SDLInput.hpp"
+#include "ppu/SDLVideoSink.hpp"
+#include "YumeBoyCore.hpp"
+
+
+namespace {
+
+constexpr std::string_view USAGE = R"(Usage: YumeBoy <rom> [options]
+  --skip-bootrom      start the cartridge right away instead of running the boot ROM
+  --headless          run without a window and without audio
+  --fast              run in the fast execution mode instead of the accurate one
+  --frames <n>        stop after n frames (of 70224 T-cycles each)
+  --cycles <n>        stop after n T-cycles
+  --speed <x>         run at x times the speed of a Game Boy, 0 runs as fast as possible (default: 1)
+  --savestate <file>  continue from a save state of the same ROM
+  --bench             print the startup time, the emulated MHz and frames per second on exit
+  --help              print this message
+Without --frames or --cycles, the emulation runs until the window is closed.
+)";
+
+struct Options {
+    std::string rom_path;
+    bool skip_bootrom = false;
+    bool headless = false;
+    bool fast = false;
+    std::optional<uint64_t> t_cycles;   // the T-cycles to run, until the window is closed if not given
+    double speed = 1;
+    std::optional<std::string> savestate;
+    bool bench = false;
+    bool help = false;
+};
+
+template <typename T>
+T parse_number(std::string_view option, std::string_view text)
+{
+    T number{};
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (error != std::errc() or end != text.data() + text.size())
+        throw std::invalid_argument(std::format("{} expects a number, not '{}'", option, text));
+    return number;
+}
+
+/* Throws `std::invalid_argument` for anything it does not understand. */
+Options parse_options(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&] {
+            if (i + 1 == argc)
+                throw std::invalid_argument(std::format("{} expects a value", arg));
+            return std::string_view(argv[++i]);
+        };
+
+        if (arg == "--skip-bootrom")
+            options.skip_bootrom = true;
+        else if (arg == "--headless")
+            options.headless = true;
+        else if (arg == "--fast")
+            options.fast = true;
+        else if (arg == "--frames") {
+            auto frames = parse_number<uint64_t>(arg, value());
+            constexpr uint64_t MAX_FRAMES = std::numeric_limits<uint64_t>::max() / LCD::FRAME_T_CYCLES;
+            if (frames > MAX_FRAMES)
+                throw std::invalid_argument(std::format("--frames expects at most {} frames", MAX_FRAMES));
+            options.t_cycles = frames * LCD::FRAME_T_CYCLES;
+        }
+        else if (arg == "--cycles")
+            options.t_cycles = parse_number<uint64_t>(arg, value());
+        else if (arg == "--speed") {
+            options.speed = parse_number<double>(arg, value());
+            if (options.speed < 0)
+                throw std::invalid_argument("--speed expects a speed of at least 0");
+        }
+        else if (arg == "--savestate")
+            options.savestate = value();
+        else if (arg == "--bench")
+            options.bench = true;
+        else if (arg == "--help" or arg == "-h")
+            options.help = true;
+        else if (arg.starts_with("-"))
+            throw std::invalid_argument(std::format("Unknown option {}", arg));
+        else if (options.rom_path.empty())
+            options.rom_path = arg;
+        else
+            throw std::invalid_argument(std::format("Only one ROM can be run, got {} and {}", options.rom_path, arg));
+    }
+
+    if (options.rom_path.empty() and not options.help)
+        throw std::invalid_argument("No ROM given");
+    return options;
+}
+
+int run(Options &options)
+{
+    const auto startup_time = std::chrono::steady_clock::now();
+    std::unique_ptr<VideoSink> video;
+    std::unique_ptr<AudioSink> audio;
+    SDLVideoSink *window = nullptr;
+    if (not options.headless) {
+        auto sdl_video = std::make_unique<SDLVideoSink>("YumeBoy", LCD::DISPLAY_WIDTH * 4, LCD::DISPLAY_HEIGHT * 4);
+        window = sdl_video.get();
+        video = std::move(sdl_video);
+        audio = std::make_unique<SDLAudioSink>();
+    }
+
+    YumeBoyCore core(std::move(video), std::move(audio));
+    core.load_rom(options.rom_path, options.skip_bootrom);
+    YumeBoy &yume_boy = core.yume_boy();
+
+    if (options.savestate and not yume_boy.load_state(*options.savestate)) {
+        std::cerr << std::format("Unable to load the save state {} for {}\n", *options.savestate, options.rom_path);
+        return 1;
+    }
+
+    yume_boy.execution_mode(options.fast ? YumeBoy::ExecutionMode::Fast : YumeBoy::ExecutionMode::Accurate);
+    yume_boy.speed(options.speed);
+    yume_boy.pacing(YumeBoy::Pacing::Audio);
+
+    std::optional<SDLInput> input;
+    if (window)
+        input.emplace(core);
+
+    const uint64_t t_cycles = options.t_cycles.value_or(std::numeric_limits<uint64_t>::max());
+    const uint64_t start = core.t_cycles();
+    const auto start_time = std::chrono::steady_clock::now();
+    const std::chrono::duration<double, std::milli> startup = start_time - startup_time;
+
+    // run a frame at a time, the input is applied in between
+    auto emulate = [&] {
+        for (uint64_t ran = 0; ran < t_cycles; ran = core.t_cycles() - start) {
+            if (input) {
+                input->apply();
+                if (input->quit_requested())
+                    break;
+            }
+            core.run(std::min(t_cycles - ran, LCD::FRAME_T_CYCLES));
+        }
+    };
+
+    if (window) {
+        // SDL only allows its video and event functions on the main thread, so the emulation runs on another thread
+        // while the main thread handles the events and presents the frames
+        std::atomic<bool> finished = false;
+        std::exception_ptr error;
+        std::jthread emulation([&] {
+            try {
+                emulate();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            finished = true;
+        });
+
+        while (not finished) {
+            // woken up by every presented frame, the timeout notices the end of the emulation
+            SDL_WaitEventTimeout(nullptr, 10);
+            input->poll();
+            window->show_latest();
+        }
+        emulation.join();
+        if (error)
+            std::rethrow_exception(error);
+    } else {
+        emulate();
+    }
+
+    if (options.bench) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        double ran = double(core.t_cycles() - start);
+        double frames = ran / double(LCD::FRAME_T_CYCLES);
+        std::cout << std::format("startup (sinks and ROM) in {:.2f} ms\n", startup.count())
+                  << std::format("{:.0f} T-cycles ({:.1f} frames) in {:.3f} s: {:.2f} MHz, {:.1f} frames/s, "
+                                 "{:.1f} us/frame ({:.2f}x real time)\n",
+                                 ran, frames, seconds, ran / seconds / 1e6, frames / seconds, seconds / frames * 1e6,
+                                 ran / seconds / APU::CLOCK_RATE);
+    }
     return 0;
 }
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::invalid_argument &e) {
+        std::cerr << e.what() << "\n\n" << USAGE;
+        return 2;
+    }
+
+    if (options.help) {
+        std::cout << USAGE;
+        return 0;
+    }
+
+    int status = 1;
+    try {
+        status = run(options);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+    }
+    SDL_Quit();     // the sinks have closed the window and the audio device by now
+    return status;
+}
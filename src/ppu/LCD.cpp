@@ -1,73 +1,88 @@
 #include "ppu/LCD.hpp"
 
 #include <cassert>
-#include <vector>
-#include <iostream>
+#include <cmath>
+#include <cstring>
 
 #include <savestate/LCDSaveState.hpp>
 
 
-void LCD::push_pixel(Color c)
+void LCD::push_pixel(uint32_t color)
 {
     assert(buffer_it != pixel_buffer.end());
 
-    switch (c)
-    {
-    case Color::WHITE:
-        *buffer_it++ = 233;
-        *buffer_it++ = 239;
-        *buffer_it++ = 236;
-        *buffer_it++ = 255;
-        break;
-
-    case Color::LIGHT_GRAY:
-        *buffer_it++ = 160;
-        *buffer_it++ = 160;
-        *buffer_it++ = 139;
-        *buffer_it++ = 255;
-        break;
-
-    case Color::DARK_GRAY:
-        *buffer_it++ = 85;
-        *buffer_it++ = 85;
-        *buffer_it++ = 104;
-        *buffer_it++ = 255;
-        break;
-
-    case Color::BLACK:
-        *buffer_it++ = 33;
-        *buffer_it++ = 30;
-        *buffer_it++ = 32;
-        *buffer_it++ = 255;
-        break;
-
-    default:
-        std::unreachable();
-    }
+    if (std::memcmp(&*buffer_it, &color, sizeof(color)) != 0)
+        dirty_lines.set(pushed_pixels() / DISPLAY_WIDTH);
+    std::memcpy(&*buffer_it, &color, sizeof(color));
+    buffer_it += sizeof(color);
+}
+
+void LCD::push_pixels(std::span<const uint32_t> colors)
+{
+    assert(pushed_pixels() % DISPLAY_WIDTH + colors.size() <= DISPLAY_WIDTH);
+
+    size_t line = pushed_pixels() / DISPLAY_WIDTH;
+    if (not dirty_lines[line] and std::memcmp(&*buffer_it, colors.data(), colors.size_bytes()) != 0)
+        dirty_lines.set(line);
+    std::memcpy(&*buffer_it, colors.data(), colors.size_bytes());
+    buffer_it += colors.size_bytes();
 }
 
 void LCD::update_screen()
 {
     assert(buffer_it == pixel_buffer.end());
 
-    if (power_) [[likely]]
-    {
-        SDL_UpdateTexture(pixel_matrix_texture.get(), nullptr, pixel_buffer.data(), DISPLAY_WIDTH * sizeof(uint8_t) * 4);
+    if (frames_to_skip != 0)
+        --frames_to_skip;
+    else if (sink) {
+        // the pixel buffer is not presented while the LCD is turned off, it is still compared against though
+        static const pixel_buffer_t blank{};
+        bool present_blank = not power_;
+        if (present_blank != blank_presented)
+            dirty_lines.set();
+        else if (present_blank)
+            dirty_lines.reset();
+
+        if (dirty_lines.none())
+            ++frame_counters_.unchanged;
+        else if (dirty_lines.all())
+            ++frame_counters_.full;
+        else
+            ++frame_counters_.partial;
+
+        sink->present(present_blank ? blank : pixel_buffer, dirty_lines);
+        frames_to_skip = frame_skip_;
+        blank_presented = present_blank;
+        dirty_lines.reset();
     }
-    else
-    {
-        SDL_UpdateTexture(pixel_matrix_texture.get(), nullptr, std::vector<uint8_t>(255).data(), DISPLAY_WIDTH * sizeof(uint8_t) * 4);
-    }
-    SDL_RenderTexture(renderer.get(), pixel_matrix_texture.get(), nullptr, nullptr);
-    SDL_RenderPresent(renderer.get());
 
     buffer_it = pixel_buffer.begin();
 
-    // check if the next frame should be rendered or if the thread should sleep
-    if (SDL_GetTicksNS() < next_frame) {
-        SDL_DelayNS(next_frame - SDL_GetTicksNS());
-    }
-    next_frame = SDL_GetTicksNS() + FRAME_NS;
+    // sleep until the next frame should be rendered
+    pacer.wait();
+}
+
+void LCD::skip_frame()
+{
+    if (frames_to_skip != 0)
+        --frames_to_skip;
+
+    buffer_it = pixel_buffer.begin();
+
+    // sleep until the next frame should be rendered
+    pacer.wait();
+}
+
+double LCD::speed() const
+{
+    if (pacer.frame_time() == std::chrono::nanoseconds::zero()) return 0;
+    return double(FRAME_NS) / double(std::chrono::nanoseconds(pacer.frame_time()).count());
+}
+
+void LCD::speed(double speed)
+{
+    assert(speed >= 0);
+    pacer.frame_time(speed > 0 ? std::chrono::nanoseconds(std::llround(double(FRAME_NS) / speed)) : std::chrono::nanoseconds::zero());
 }
 
 LCDSaveState LCD::save_state()
@@ -78,7 +93,7 @@ LCDSaveState LCD::save_state()
 
         power_,
 
-        next_frame,
+        uint64_t(std::chrono::nanoseconds(pacer.time_left()).count()),
     };
     return s;
 }
@@ -89,59 +104,7 @@ void LCD::load_state(LCDSaveState state)
     buffer_it = pixel_buffer.begin() + state.buffer_it;
 
     power_ = state.power_;
+    dirty_lines.set();
 
-    next_frame = state.next_frame;
-}
-
-#ifndef NDEBUG
-bool LCD::screenshot(const char *fileName) const
-{
-    float width_f, height_f;
-    SDL_GetTextureSize(pixel_matrix_texture.get(), &width_f, &height_f);
-    auto width = (int)width_f;
-    auto height = (int)height_f;
-
-    // Create a target texture that allows rendering
-    SDL_Texture* renderableTexture = SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
-    if (!renderableTexture) {
-        std::cerr << "Failed to create renderable texture: " << SDL_GetError() << std::endl;
-        return false;
-    }
-
-    // Set the target texture as the rendering target
-    if (not SDL_SetRenderTarget(renderer.get(), renderableTexture)) {
-        std::cerr << "Failed to set render target: " << SDL_GetError() << std::endl;
-        SDL_DestroyTexture(renderableTexture);
-        return false;
-    }
-
-    // Copy the streaming texture to the renderable target texture
-    if (not SDL_RenderTexture(renderer.get(), pixel_matrix_texture.get(), nullptr, nullptr)) {
-        std::cerr << "Failed to copy texture: " << SDL_GetError() << std::endl;
-        SDL_DestroyTexture(renderableTexture);
-        return false;
-    }
-
-    // Read pixels from the renderable target texture
-    SDL_Surface* surface = SDL_RenderReadPixels(renderer.get(), nullptr);
-    if (not surface) {
-        std::cerr << "Failed to read pixels: " << SDL_GetError() << std::endl;
-        SDL_DestroyTexture(renderableTexture);
-        return false;
-    }
-
-    // Save the surface as a BMP file
-    if (SDL_SaveBMP(surface, fileName) != 0) {
-        std::cerr << "Failed to save BMP: " << SDL_GetError() << std::endl;
-    }
-
-    // Clean up
-    SDL_DestroySurface(surface);
-    SDL_DestroyTexture(renderableTexture);
-
-    // Reset the rendering target back to the default (usually the window)
-    SDL_SetRenderTarget(renderer.get(), nullptr);
-
-    return true;
-}
-#endif
\ No newline at end of file
+    pacer.delay(std::chrono::nanoseconds(state.next_frame));
+}
\ No newline at end of file
@@ -84,6 +84,7 @@ void PPU::write_vram(uint16_t addr, uint8_t value)
     if (state == PPU_STATES::PixelTransfer)
         return;
     vram_[addr - VRAM_BEGIN] = value;
+    tile_cache.update(vram_, addr - VRAM_BEGIN);
 }
 
 uint8_t PPU::read_oam_ram(uint16_t addr)
@@ -139,6 +140,11 @@ uint8_t PPU::read_lcd_register(uint16_t addr) const
 void PPU::write_lcd_register(uint16_t addr, uint8_t value)
 {
     assert(LCD_REG_BEGIN <= addr and addr <= LCD_REG_END);
+
+    // the rendered scanline does not reflect the new value of a register that affects the picture, the pixel FIFO takes over
+    if (scanline_rendered and addr != 0xFF41 and addr != 0xFF44 and addr != 0xFF45 and value != read_lcd_register(addr))
+        replay_pixel_transfer(scanline_time_);
+
     switch (addr)
     {
     case 0xFF40:
@@ -162,12 +168,15 @@ void PPU::write_lcd_register(uint16_t addr, uint8_t value)
         break;
     case 0xFF47:
         BGP = value;
+        update_palette(BG);
         break;
     case 0xFF48:
         OBP0 = value;
+        update_palette(S0);
         break;
     case 0xFF49:
         OBP1 = value;
+        update_palette(S1);
         break;
     case 0xFF4A:
         WY = value;
@@ -180,6 +189,34 @@ void PPU::write_lcd_register(uint16_t addr, uint8_t value)
     }
 }
 
+void PPU::update_palette(ColorPallet pallet)
+{
+    uint8_t value;
+    switch (pallet)
+    {
+    case BG:
+        value = BGP;
+        break;
+    case S0:
+        value = OBP0;
+        break;
+    case S1:
+        value = OBP1;
+        break;
+    default:
+        std::unreachable();
+    }
+
+    for (uint8_t i = 0; i < 4; ++i)
+        palettes[pallet][i] = lcd.color(LCD::Color((value >> (2 * i)) & 0b11));
+}
+
+void PPU::update_palettes()
+{
+    for (ColorPallet pallet : { BG, S0, S1 })
+        update_palette(pallet);
+}
+
 void PPU::h_blank_tick()
 {
     if (scanline_time_ == 456)
@@ -190,7 +227,10 @@ void PPU::h_blank_tick()
         {
             set_mode(PPU_STATES::VBlank);
             interrupts.request_interrupt(InterruptBus::INTERRUPT::V_BLANK_INTERRUPT);
-            lcd.update_screen();
+            if (skip_frame)
+                lcd.skip_frame();
+            else
+                lcd.update_screen();
         }
         else
         {
@@ -219,6 +259,7 @@ void PPU::v_blank_tick()
                 STAT &= 0b11111011;
             }
             set_mode(PPU_STATES::OAMScan);
+            skip_frame = lcd.skipping_frame();
         }
         scanline_time_ = 0;
     }
@@ -230,21 +271,28 @@ void PPU::oam_scan_tick()
     if (scanline_time_ % 2 != 0) return;
 
     /* Scan the OAM RAM. The CPU has no access to the OAM RAM in this mode. */
-    if (oam_pointer == OAM_RAM_BEGIN)
-        scanline_sprites.clear();
+    if (oam_pointer == OAM_RAM_BEGIN) {
+        scanline_sprite_count = 0;
+        next_sprite = 0;
+    }
 
-    auto e = std::make_unique<OAM_entry>(
+    OAM_entry e = {
         oam_ram_[oam_pointer - OAM_RAM_BEGIN],
         oam_ram_[oam_pointer - OAM_RAM_BEGIN + 1],
         oam_ram_[oam_pointer - OAM_RAM_BEGIN + 2],
-        oam_ram_[oam_pointer - OAM_RAM_BEGIN + 3]);
+        oam_ram_[oam_pointer - OAM_RAM_BEGIN + 3],
+    };
     oam_pointer += 4;
 
     // check if the OAM entry is visible on the current scanline
     uint8_t sprite_height = 8 + (8 * ((LCDC >> 2) & 1));
-    if ((scanline_sprites.size() < 10) and (LY + 16 >= e->y and LY + 16 < e->y + sprite_height))
+    if ((scanline_sprite_count < scanline_sprites.size()) and (LY + 16 >= e.y and LY + 16 < e.y + sprite_height))
     {
-        scanline_sprites.push_back(std::move(e));
+        // insert sorted by X position, behind sprites with the same X position
+        uint8_t i = scanline_sprite_count++;
+        for (; i > 0 and scanline_sprites[i - 1].x > e.x; --i)
+            scanline_sprites[i] = scanline_sprites[i - 1];
+        scanline_sprites[i] = e;
     }
 
     if (oam_pointer == OAM_RAM_END + 1)
@@ -252,11 +300,21 @@ void PPU::oam_scan_tick()
         assert(scanline_time_ == 80);
         set_mode(PPU_STATES::PixelTransfer);
         oam_pointer = OAM_RAM_BEGIN;
+        if (renderer_ == Renderer::Scanline)
+            render_scanline();
     }
 }
 
 void PPU::pixel_transfer_tick()
 {
+    // the scanline has already been rendered, wait until the pixel FIFO would have finished it
+    if (scanline_rendered)
+    {
+        if (scanline_time_ == pixel_transfer_end)
+            finish_scanline();
+        return;
+    }
+
     // the pixel fetcher is two times slower than the rest of the ppu
     if (scanline_time_ % 2 == 0)
         fetcher.tick();
@@ -266,22 +324,16 @@ void PPU::pixel_transfer_tick()
         return;
 
     // if a sprite is at the current x position, switch the fetcher into sprite fetch mode
-    if (auto it = std::find_if(
-            scanline_sprites.begin(),
-            scanline_sprites.end(),
-            [&](const std::unique_ptr<OAM_entry>& e)
-            { return e->x <= fifo_pushed_pixels + 9; }); // TODO not entirely sure why we have to offset by 9, seems like a bug elsewhere (handle special case where sprite is cut off at the left edge of the LCD)
-        it != scanline_sprites.end())
+    // TODO not entirely sure why we have to offset by 9, seems like a bug elsewhere (handle special case where sprite is cut off at the left edge of the LCD)
+    if (next_sprite < scanline_sprite_count and scanline_sprites[next_sprite].x <= fifo_pushed_pixels + 9)
     {
-        fetcher.fetch_sprite(std::move(*it));  // TODO what if sprites are disabled?
-        scanline_sprites.erase(it);
+        fetcher.fetch_sprite(scanline_sprites[next_sprite++]);  // TODO what if sprites are disabled?
     }
 
     // if scanline is at the beginning, skip pixels based on SCX offset
     if (fifo_pushed_pixels == 0)
     {
-        for (int i = 0; i < SCX % 8; ++i)
-            BG_FIFO.pop();
+        BG_FIFO.pop(SCX % 8);
     }
 
     Pixel px = BG_FIFO.front();
@@ -289,60 +341,163 @@ void PPU::pixel_transfer_tick()
     assert((px.color & 0b11) == px.color);
 
     // merge the BG and sprite pixels if a sprite pixel is available
+    Pixel sp = { 0, S0, false };
     if (not Sprite_FIFO.empty())
     {
-        Pixel sp = Sprite_FIFO.front();
+        sp = Sprite_FIFO.front();
         Sprite_FIFO.pop();
+    }
 
-        // check if sprite pixel is not transparent and that sprites are enabled
-        assert((sp.color & 0b11) == sp.color);
-        if (sp.color > 0 and LCDC & 1 << 1)
-        {
-            // check bg priority of sprite
-            px = sp.bg_priority and px.color > 0 ? px : sp;
-        }
+    // push the pixel to the LCD
+    if (not skip_frame)
+    {
+        lcd.push_pixel(color(px, sp));
+    }
+
+    // if the last pixel of the scanline was pushed, move on to H-Blank mode
+    if (++fifo_pushed_pixels == 160)
+    {
+        fetcher.reset();
+        BG_FIFO.clear();
+        Sprite_FIFO.clear();
+        set_mode(PPU_STATES::HBlank);
+    }
+}
+
+uint32_t PPU::color(Pixel px, Pixel sp) const
+{
+    // check if sprite pixel is not transparent and that sprites are enabled
+    assert((sp.color & 0b11) == sp.color);
+    if (sp.color > 0 and LCDC & 1 << 1)
+    {
+        // check bg priority of sprite
+        px = sp.bg_priority and px.color > 0 ? px : sp;
     }
 
     // if BG is disabled, make BG pixels use color ID 0
     if (not(LCDC & 1) and px.pallet == BG)
         px.color = 0;
 
-    // retrieve color from pallet and push to LCD
+    // retrieve color from pallet
     assert(px.pallet == BG or px.color != 0);
-    uint8_t c;
-    switch (px.pallet)
-    {
-    case BG:
-    {
-        c = (BGP >> (2 * px.color)) & 0b11;
-        break;
-    }
-    case S0:
+    assert(px.pallet <= S1 and px.color <= 3);
+    return palettes[px.pallet][px.color];
+}
+
+void PPU::render_scanline()
+{
+    /* BG and window: the fetcher pushes the rows of the tiles one after another (see `PixelFetcher::tick`), of which the
+       first SCX % 8 pixels are discarded. */
+    const uint8_t discarded = SCX % 8;
+    std::array<uint8_t, 168> bg;    // the pixels of the fetched tiles, including the discarded ones
+    for (uint8_t fetcher_x = 0; not skip_frame and fetcher_x * 8 < 160 + discarded; ++fetcher_x)
     {
-        c = (OBP0 >> (2 * px.color)) & 0b11;
-        break;
+        bool fetch_window = LCDC & 1 << 5 and WY <= LY and WX <= fetcher_x;
+        uint16_t tile_map_addr = LCDC & 1 << (3 + 3 * int(fetch_window)) ? 0x9C00 : 0x9800;
+
+        uint8_t x = fetch_window ? fetcher_x - ((WX - 7) / 8) : ((SCX / 8) + fetcher_x) & 0x1F;
+        uint8_t y = fetch_window ? (LY - WY) / 8 : (((LY + SCY) & 0xFF) / 8);
+        assert(x < 32 and y < 32);
+        uint8_t tile_id = vram_[tile_map_addr + x + (y * 0x20) - VRAM_BEGIN];
+
+        uint16_t tile_data_addr = LCDC & 1 << 4 ? uint16_t(0x8000 + (tile_id << 4)) : uint16_t(0x9000 + (tile_id << 4));
+        uint8_t line_offset = fetch_window ? ((LY - WY) % 8) * 2 : ((LY + SCY) % 8) * 2;
+        const TileCache::Row &row = tile_cache.row(tile_data_addr - VRAM_BEGIN + line_offset);
+        std::ranges::copy(row, bg.begin() + fetcher_x * 8);
     }
-    case S1:
+
+    /* Timing: the pixel FIFO resumes pushing a pixel per T-cycle at `resume`, beginning with pixel `first`. First, the
+       `available` pixels that are left in the BG FIFO are pushed. The fetcher pushes the next tile 8 T-cycles after
+       `resume`, from then on there are no gaps. Initially, the first tile is pushed in T-cycle 88. */
+    uint32_t resume = 88;
+    int first = 0;
+    int available = 8 - discarded;
+    auto push_time = [&](int n) -> uint32_t {
+        int d = n - first;
+        return d < available ? resume + d : resume + 8 + (d - available);
+    };
+
+    /* Sprites: a sprite fetch starts while the first pixel with `x <= pixel + 9` is pushed, but at most one per pixel
+       (see `pixel_transfer_tick`). It stops the pixel FIFO until the fetcher has pushed the sprite pixels 4 fetcher
+       steps later. Afterwards, the fetcher starts over with the BG tile it was fetching. */
+    std::array<Pixel, 160> sprites{};
+    int sprite_fifo_end = 0;    // the pixel after the last one covered by the sprite FIFO
+    int fetch_pixel = -1;       // the pixel at which the last sprite fetch started
+    for (uint8_t k = 0; k < scanline_sprite_count; ++k)
     {
-        c = (OBP1 >> (2 * px.color)) & 0b11;
-        break;
-    }
-    default:
-        std::unreachable();
+        const OAM_entry &e = scanline_sprites[k];
+        // a sprite fetch during the last pixel has no effect
+        fetch_pixel = std::max({ e.x - 9, fetch_pixel + 1, 0 });
+        if (fetch_pixel >= 159) break;
+
+        uint32_t t = push_time(fetch_pixel);
+        int d = fetch_pixel - first;
+        available = d < available ? available - d - 1 : 7 - (d - available) % 8;
+        resume = t + (t % 2 == 0 ? 8 : 7);
+        first = fetch_pixel + 1;
+        if (skip_frame) continue;
+
+        auto tile_data_addr = uint16_t(0x8000 + (e.tile_id << 4));
+        uint8_t line_offset = e.flags & (1 << 5) ? (7 - ((LY + e.y) % 8)) * 2 : ((LY + e.y) % 8) * 2;
+        const TileCache::Row &row = tile_cache.row(tile_data_addr - VRAM_BEGIN + line_offset, e.flags & (1 << 6));
+
+        // the sprite pixels are appended to the pixels of previous sprites that are still in the sprite FIFO
+        int size = std::max(0, sprite_fifo_end - first);
+        for (int i = 0; i < 8; ++i)
+        {
+            if (size > i or e.x + i < 8)
+                continue;
+            if (first + size < 160)
+                sprites[first + size] = { row[i], e.flags & 1 << 4 ? S1 : S0, bool(e.flags & 1 << 7) };
+            ++size;
+        }
+        sprite_fifo_end = first + size;
     }
 
-    assert(c <= 3);
-    lcd.push_pixel((LCD::Color)c);
+    for (int n = 0; not skip_frame and n < 160; ++n)
+        scanline[n] = color({ bg[n + discarded], BG, false }, sprites[n]);
+    pixel_transfer_end = push_time(159);
+    scanline_rendered = true;
+}
 
-    // if the last pixel of the scanline was pushed, move on to H-Blank mode
-    if (++fifo_pushed_pixels == 160)
+void PPU::finish_scanline()
+{
+    assert(scanline_rendered and scanline_time_ == pixel_transfer_end);
+    scanline_rendered = false;
+
+    fifo_pushed_pixels = 160;
+    fetcher.reset();
+    BG_FIFO.clear();
+    Sprite_FIFO.clear();
+    set_mode(PPU_STATES::HBlank);
+
+    if (not skip_frame)
+        lcd.push_pixels(scanline);
+}
+
+void PPU::renderer(Renderer renderer)
+{
+    // the pixel FIFO continues the pixel transfer of a rendered scanline
+    if (renderer == Renderer::FIFO and scanline_rendered)
+        replay_pixel_transfer(scanline_time_);
+    renderer_ = renderer;
+}
+
+void PPU::replay_pixel_transfer(uint32_t until)
+{
+    assert(state == PPU_STATES::PixelTransfer);
+    scanline_rendered = false;
+    fetcher.reset();
+    BG_FIFO.clear();
+    Sprite_FIFO.clear();
+    fifo_pushed_pixels = 0;
+    next_sprite = 0;
+
+    // the pixel transfer begins after the 80 T-cycles of the OAM scan
+    for (scanline_time_ = 80; scanline_time_ < until and state == PPU_STATES::PixelTransfer;)
     {
-        fetcher.reset();
-        while (not BG_FIFO.empty())
-            BG_FIFO.pop();
-        while (not Sprite_FIFO.empty())
-            Sprite_FIFO.pop();
-        set_mode(PPU_STATES::HBlank);
+        ++scanline_time_;
+        pixel_transfer_tick();
     }
 }
 
@@ -380,6 +535,50 @@ void PPU::tick() {
         interrupts.request_interrupt(InterruptBus::INTERRUPT::STAT_INTERRUPT);
 }
 
+void PPU::tick(uint32_t t_cycles) {
+    // skip if LCD is turned off
+    if (not (LCDC & 1 << 7)) return;
+
+    while (t_cycles > 0) {
+        // nothing happens during H-Blank and V-Blank until the end of the scanline is reached, the same applies to the
+        // pixel transfer of a rendered scanline
+        uint32_t idle_end = 0;
+        if (state == PPU_STATES::HBlank or state == PPU_STATES::VBlank)
+            idle_end = 456;
+        else if (state == PPU_STATES::PixelTransfer and scanline_rendered)
+            idle_end = pixel_transfer_end;
+
+        if (scanline_time_ + 1 < idle_end) {
+            uint32_t idle = std::min(t_cycles, idle_end - scanline_time_ - 1);
+            scanline_time_ += idle;
+            t_cycles -= idle;
+            continue;
+        }
+
+        tick();
+        --t_cycles;
+    }
+}
+
+std::optional<uint32_t> PPU::cycles_until_event() const
+{
+    if (not (LCDC & 1 << 7)) return std::nullopt;
+
+    switch (state) {
+        using enum PPU_STATES;
+        case HBlank:
+        case VBlank:
+            return 456 - scanline_time_;
+        case OAMScan:
+            // the OAM scan takes 80 T-cycles and pushing the 160 pixels of the scanline at least another 160 T-cycles
+            return 80 - scanline_time_ + 160;
+        case PixelTransfer:
+            return scanline_rendered ? pixel_transfer_end - scanline_time_ : 160 - fifo_pushed_pixels;
+        default:
+            std::unreachable();
+    }
+}
+
 bool PPU::contains_address(uint16_t addr) const
 {
     return (0x8000 <= addr and addr <= 0x9FFF) or (0xFE00 <= addr and addr <= 0xFE9F) or (0xFF40 <= addr and addr <= 0xFF45) or (0xFF47 <= addr and addr <= 0xFF4B);
@@ -410,7 +609,11 @@ void PPU::write_memory(uint16_t addr, uint8_t value)
         std::unreachable();
 }
 
-PPUSaveState PPU::save_state() const {
+PPUSaveState PPU::save_state() {
+    // the save state contains the progress of the pixel FIFO
+    if (scanline_rendered)
+        replay_pixel_transfer(scanline_time_);
+
     PPUSaveState s = {
         state,
         scanline_time_,
@@ -430,8 +633,8 @@ PPUSaveState PPU::save_state() const {
         WX,
 
         oam_pointer,
-        BG_FIFO,
-        Sprite_FIFO,
+        BG_FIFO.save_state(),
+        Sprite_FIFO.save_state(),
         fifo_pushed_pixels,
         fetcher.save_state(),
     };
@@ -444,6 +647,7 @@ void PPU::load_state(PPUSaveState ppu_state) {
     scanline_time_ = ppu_state.scanline_time_;
 
     vram_ = ppu_state.vram_;
+    tile_cache.rebuild(vram_);
     oam_ram_ = ppu_state.oam_ram_;
 
     LCDC = ppu_state.LCDC;
@@ -454,14 +658,18 @@ void PPU::load_state(PPUSaveState ppu_state) {
     LYC = ppu_state.LYC;
     BGP = ppu_state.BGP;
     OBP0 = ppu_state.OBP0;
+    update_palettes();
     WY = ppu_state.WY;
     WX = ppu_state.WX;
 
     oam_pointer = ppu_state.oam_pointer;
-    BG_FIFO = ppu_state.BG_FIFO;
-    Sprite_FIFO = ppu_state.Sprite_FIFO;
+    BG_FIFO.load_state(ppu_state.BG_FIFO);
+    Sprite_FIFO.load_state(ppu_state.Sprite_FIFO);
     fifo_pushed_pixels = ppu_state.fifo_pushed_pixels;
     fetcher.load_state(ppu_state.fetcher);
+    scanline_rendered = false;
+    // the pixels of the current frame have not been pushed if it was skipped when the state was saved
+    skip_frame = lcd.pushed_pixels() != (LY < 144 ? size_t(LY) * 160 + fifo_pushed_pixels : 0);
 }
     
 OAMEntrySaveState OAM_entry::save_state() const {
@@ -474,7 +682,7 @@ OAMEntrySaveState OAM_entry::save_state() const {
     return s;
 }
 
-std::unique_ptr<OAM_entry> OAM_entry::load_state(OAMEntrySaveState state)
+OAM_entry OAM_entry::load_state(OAMEntrySaveState state)
 {
-    return std::make_unique<OAM_entry>(state.y, state.x, state.tile_id, state.flags);
+    return { state.y, state.x, state.tile_id, state.flags };
 }
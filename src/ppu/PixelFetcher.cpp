@@ -15,7 +15,7 @@ void PixelFetcher::tick()
         uint16_t tile_map_addr = p.LCDC & 1 << (3 + 3 * int(fetch_window)) ? 0x9C00 : 0x9800;
 
         uint8_t x = fetch_window ? fetcher_x - ((p.WX - 7) / 8) : ((p.SCX / 8) + fetcher_x) & 0x1F;
-        uint8_t y = fetch_window ? p.LY - (p.WY / 8) : (((p.LY + p.SCY) & 0xFF) / 8);
+        uint8_t y = fetch_window ? (p.LY - p.WY) / 8 : (((p.LY + p.SCY) & 0xFF) / 8);
         assert(x < 32 and y < 32);
 
         uint16_t tile_id_addr = tile_map_addr + x + (y * 0x20);
@@ -53,11 +53,11 @@ void PixelFetcher::tick()
             break;
         }
 
-        for (int i = 7; i >= 0; --i)
-        {
-            uint8_t color = (((high_data << 1) >> i) & 0b10) | ((low_data >> i) & 0b1);
-            p.BG_FIFO.emplace(color, BG, false);
-        }
+        TileCache::Row colors = TileCache::decode(low_data, high_data);
+        std::array<Pixel, 8> row;
+        for (int i = 0; i < 8; ++i)
+            row[i] = { colors[i], BG, false };
+        p.BG_FIFO.push(row);
 
         ++fetcher_x; // increment internal x
         state = FETCHER_STATES::FetchBGTileNo;
@@ -65,7 +65,7 @@ void PixelFetcher::tick()
     }
 
     case FETCHER_STATES::FetchSpriteTileNo: {
-        tile_id = oam_entry->tile_id;
+        tile_id = oam_entry.tile_id;
 
         state = FETCHER_STATES::FetchSpriteTileDataLow;
         break;
@@ -73,7 +73,7 @@ void PixelFetcher::tick()
 
     case FETCHER_STATES::FetchSpriteTileDataLow: {
         auto tile_data_addr = uint16_t(0x8000 + (tile_id << 4));
-        uint8_t line_offset = oam_entry->flags & (1 << 5) ? (7 - ((p.LY + oam_entry->y) % 8)) * 2 : ((p.LY + oam_entry->y) % 8) * 2;
+        uint8_t line_offset = oam_entry.flags & (1 << 5) ? (7 - ((p.LY + oam_entry.y) % 8)) * 2 : ((p.LY + oam_entry.y) % 8) * 2;
         low_data = p.vram_[tile_data_addr - VRAM_BEGIN + line_offset];
 
         state = FETCHER_STATES::FetchSpriteTileDataHigh;
@@ -82,7 +82,7 @@ void PixelFetcher::tick()
 
     case FETCHER_STATES::FetchSpriteTileDataHigh: {
         auto tile_data_addr = uint16_t(0x8000 + (tile_id << 4));
-        uint8_t line_offset = oam_entry->flags & 1 << 5 ? (7 - ((p.LY + oam_entry->y) % 8)) * 2 : ((p.LY + oam_entry->y) % 8) * 2;
+        uint8_t line_offset = oam_entry.flags & 1 << 5 ? (7 - ((p.LY + oam_entry.y) % 8)) * 2 : ((p.LY + oam_entry.y) % 8) * 2;
         high_data = p.vram_[tile_data_addr - VRAM_BEGIN + line_offset + 1];
 
         state = FETCHER_STATES::PushToSpriteFIFO;
@@ -90,18 +90,17 @@ void PixelFetcher::tick()
     }
 
     case FETCHER_STATES::PushToSpriteFIFO: {
+        // flip pixels horizontally if flag is set
+        TileCache::Row colors = TileCache::decode(low_data, high_data, oam_entry.flags & (1 << 6));
         for (int i = 0; i < 8; ++i)
         {
-            // flip pixels vertically if flag is set
-            int j = oam_entry->flags & (1 << 6) ? i : 7 - i;
-            assert(j >= 0);
-            uint8_t color = (((high_data << 1) >> j) & 0b10) | ((low_data >> j) & 0b1);
-            ColorPallet pallet = oam_entry->flags & 1 << 4 ? S1 : S0;
+            uint8_t color = colors[i];
+            ColorPallet pallet = oam_entry.flags & 1 << 4 ? S1 : S0;
 
             // skip pixel if another sprite already occupies the pixel or if it is off-screen
-            if (p.Sprite_FIFO.size() > i or oam_entry->x + i < 8)
+            if (p.Sprite_FIFO.size() > i or oam_entry.x + i < 8)
                 continue;
-            p.Sprite_FIFO.emplace(color, pallet, oam_entry->flags & 1 << 7);
+            p.Sprite_FIFO.push({ color, pallet, bool(oam_entry.flags & 1 << 7) });
         }
 
         // set mode back to BG/Window fetching
@@ -116,11 +115,11 @@ void PixelFetcher::tick()
     }
 }
 
-void PixelFetcher::fetch_sprite(std::unique_ptr<OAM_entry> entry)
+void PixelFetcher::fetch_sprite(OAM_entry entry)
 {
-    assert((state & FETCHER_STATES::FetchingBGTile) != 0 and entry);
+    assert((state & FETCHER_STATES::FetchingBGTile) != 0);
     state = FETCHER_STATES::FetchSpriteTileNo;
-    oam_entry = std::move(entry);
+    oam_entry = entry;
     pixel_fifo_stopped = true;
 }
 
@@ -129,7 +128,7 @@ void PixelFetcher::reset()
     state = FETCHER_STATES::FetchBGTileNo;
     fetcher_x = 0;
     fetch_window = false;
-    oam_entry = nullptr;
+    oam_entry = {};
     tile_id = 0;
     low_data = 0;
     high_data = 0;
@@ -137,7 +136,7 @@ void PixelFetcher::reset()
 }
 
 PixelFetcherSaveState PixelFetcher::save_state() const {
-    OAMEntrySaveState oamess = oam_entry ? oam_entry->save_state() : OAMEntrySaveState{0, 0, 0, 0};
+    OAMEntrySaveState oamess = oam_entry.save_state();
     PixelFetcherSaveState s = {
         state,
 
@@ -0,0 +1,75 @@
+#include "ppu/SDLVideoSink.hpp"
+
+
+SDLVideoSink::SDLVideoSink(const char *title, int width, int height)
+{
+    SDL_Init(SDL_INIT_VIDEO);
+
+    window = std::unique_ptr<SDL_Window, sdl_deleter>(SDL_CreateWindow(title, width, height, SDL_WINDOW_BORDERLESS), sdl_deleter());
+    renderer = std::unique_ptr<SDL_Renderer, sdl_deleter>(SDL_CreateRenderer(window.get(), nullptr), sdl_deleter());
+    pixel_matrix_texture = std::unique_ptr<SDL_Texture, sdl_deleter>(SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, WIDTH, HEIGHT), sdl_deleter());
+    /* use nearest pixel scaling mode for a pixel perfect image */
+    SDL_SetTextureScaleMode(pixel_matrix_texture.get(), SDL_SCALEMODE_NEAREST);
+
+    frame_event = SDL_RegisterEvents(1);
+}
+
+SDLVideoSink::~SDLVideoSink()
+{
+    pixel_matrix_texture.reset();
+    renderer.reset();
+    window.reset();
+
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+}
+
+void SDLVideoSink::present(const Frame &frame, const DirtyLines &dirty_lines)
+{
+    PublishedFrame &back = frames.back();
+    back.frame = frame;
+    back.dirty_lines = dirty_lines;
+    back.number = ++published_frames;
+    frames.publish();
+
+    // SDL_PushEvent may be called from any thread
+    if (frame_event) {
+        SDL_Event event{};
+        event.type = frame_event;
+        SDL_PushEvent(&event);
+    }
+}
+
+void SDLVideoSink::show_latest()
+{
+    if (not frames.acquire())
+        return;
+    const PublishedFrame &front = frames.front();
+
+    // the lines that changed in the frames that have been skipped are unknown
+    DirtyLines dirty_lines = front.dirty_lines;
+    if (front.number != presented + 1)
+        dirty_lines.set();
+    presented = front.number;
+
+    // nothing has to be presented if the frame did not change (the renderer does not wait for vsync)
+    if (dirty_lines.none())
+        return;
+
+    // upload each run of consecutive dirty lines
+    for (int y = 0; y < HEIGHT;)
+    {
+        if (not dirty_lines[y]) {
+            ++y;
+            continue;
+        }
+        int end = y + 1;
+        while (end < HEIGHT and dirty_lines[end])
+            ++end;
+
+        SDL_Rect rect = { 0, y, WIDTH, end - y };
+        SDL_UpdateTexture(pixel_matrix_texture.get(), &rect, front.frame.data() + y * WIDTH * 4, WIDTH * sizeof(uint8_t) * 4);
+        y = end;
+    }
+    SDL_RenderTexture(renderer.get(), pixel_matrix_texture.get(), nullptr, nullptr);
+    SDL_RenderPresent(renderer.get());
+}
@@ -0,0 +1,182 @@
+#include "serial/Serial.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <savestate/SerialSaveState.hpp>
+
+
+void Serial::shift(uint64_t t_cycle)
+{
+    // the receiving line is pulled up while nothing is plugged in, the byte of another Game Boy is only known as a whole
+    SB_ = uint8_t(SB_ << 1) | 1;
+    shift_cycles = BIT_T_CYCLES;
+
+    if (--bits_left == 0) {
+        if (link) {
+            auto received = wait_for_reply(t_cycle);
+            if (not received) {
+                awaited_reply = t_cycle;    // the transfer stays in progress until the reply arrives
+                return;
+            }
+            SB_ = *received;
+        }
+        complete_transfer();
+    }
+}
+
+void Serial::complete_transfer()
+{
+    SC_ &= 0x7F;
+    interrupts.request_interrupt(InterruptBus::INTERRUPT::SERIAL_INTERRUPT);
+    if (sink)
+        sink->receive(outgoing);
+}
+
+void Serial::complete_incoming()
+{
+    // the bits are only shifted if a transfer with the external clock is requested, otherwise the line stays pulled up
+    bool listening = (SC_ & 0b10000001) == 0b10000000;
+    // a late transfer waits for a transfer with the external clock to be requested, but not while this Game Boy sends
+    // with its internal clock: the other Game Boy may be waiting for its reply in turn
+    if (incoming->late and not listening and (SC_ & 0b10000001) != 0b10000001)
+        return;
+
+    link->send({LinkPort::Message::TYPE::Reply, listening ? SB_ : uint8_t(0xFF), incoming->t_cycle});
+    if (listening) {
+        outgoing = SB_;
+        SB_ = incoming->byte;
+        complete_transfer();
+    }
+    incoming.reset();
+}
+
+std::optional<uint8_t> Serial::wait_for_reply(uint64_t t_cycle)
+{
+    if (not link->peer_active())
+        return 0xFF;    // the other Game Boy is not run, as if nothing is plugged in
+
+    while (true) {
+        // the reply is sent before the other Game Boy tells that it has run past the transfer
+        bool passed = link->peer_t_cycle() >= t_cycle;
+        poll_link(t_cycle);
+        if (reply and reply->t_cycle == t_cycle)    // replies to transfers that were aborted are outdated
+            return std::exchange(reply, std::nullopt)->byte;
+        if (passed or not link->peer_active())
+            return std::nullopt;
+        std::this_thread::yield();
+    }
+}
+
+void Serial::poll_link(uint64_t t_cycle)
+{
+    while (auto message = link->receive()) {
+        if (message->type == LinkPort::Message::TYPE::Reply)
+            reply = message;
+        else    // replaces a transfer that was aborted
+            incoming = Incoming{message->t_cycle, message->byte, message->t_cycle < t_cycle,
+                                t_cycle + 8 * uint64_t(BIT_T_CYCLES)};
+    }
+
+    if (awaited_reply and reply and reply->t_cycle == *awaited_reply) {
+        SB_ = std::exchange(reply, std::nullopt)->byte;
+        awaited_reply.reset();
+        complete_transfer();
+    }
+    if (incoming and incoming->t_cycle <= t_cycle)
+        complete_incoming();
+}
+
+void Serial::tick(uint32_t t_cycles)
+{
+    while (bits_left > 0 and t_cycles >= shift_cycles) {
+        t_cycles -= shift_cycles;
+        shift(synced_ticks - t_cycles);
+    }
+    if (bits_left > 0)
+        shift_cycles -= uint16_t(t_cycles);
+
+    if (incoming and incoming->late and incoming->deadline <= synced_ticks) [[unlikely]]
+        incoming->late = false;     // nothing is listening, the other Game Boy gets 0xFF
+    if (incoming and not incoming->late and incoming->t_cycle <= synced_ticks) [[unlikely]]
+        complete_incoming();
+}
+
+std::optional<uint32_t> Serial::cycles_until_interrupt() const
+{
+    std::optional<uint32_t> cycles;
+    if (bits_left > 0)
+        cycles = shift_cycles + (bits_left - 1) * uint32_t(BIT_T_CYCLES);
+    if (incoming) {
+        auto incoming_cycles = uint32_t((incoming->late ? incoming->deadline : incoming->t_cycle) - synced_ticks);
+        cycles = cycles ? std::min(*cycles, incoming_cycles) : incoming_cycles;
+    }
+    return cycles;
+}
+
+void Serial::connect(LinkPort *port)
+{
+    link = port;
+    incoming.reset();
+    reply.reset();
+    awaited_reply.reset();
+}
+
+bool Serial::contains_address(uint16_t addr) const
+{
+    return (0xFF01 <= addr and addr <= 0xFF02);
+}
+
+uint8_t Serial::read_memory(uint16_t addr)
+{
+    if (addr == 0xFF01)
+        return SB_;
+    return SC_ | 0b01111110;    // the unused bits read as 1
+}
+
+void Serial::write_memory(uint16_t addr, uint8_t value)
+{
+    if (addr == 0xFF01) {
+        SB_ = value;
+        return;
+    }
+
+    SC_ = value & 0b10000001;
+    awaited_reply.reset();
+    if ((SC_ & 0b10000001) == 0b10000001) {
+        // the transfer starts with the internal clock, the timing is not aligned to the system counter
+        outgoing = SB_;
+        bits_left = 8;
+        shift_cycles = BIT_T_CYCLES;
+        if (link)
+            link->send({LinkPort::Message::TYPE::Transfer, outgoing, synced_ticks + 8 * uint64_t(BIT_T_CYCLES)});
+    } else {
+        // clearing the transfer enable bit aborts the transfer
+        bits_left = 0;
+    }
+    // a transfer that arrived late completes as soon as one with the external clock is requested, or gets 0xFF as
+    // soon as one with the internal clock starts
+    if (incoming and incoming->late)
+        complete_incoming();
+}
+
+SerialSaveState Serial::save_state() const
+{
+    SerialSaveState s = {
+        SB_,
+        SC_,
+        outgoing,
+        bits_left,
+        shift_cycles,
+    };
+    return s;
+}
+
+void Serial::load_state(SerialSaveState state)
+{
+    SB_ = state.SB_;
+    SC_ = state.SC_;
+    outgoing = state.outgoing;
+    bits_left = state.bits_left;
+    shift_cycles = state.shift_cycles;
+}
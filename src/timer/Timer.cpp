@@ -4,13 +4,8 @@
 #include <savestate/TimerSaveState.hpp>
 
 
-void Timer::tick()
+uint8_t Timer::selected_bit() const
 {
-    // based on https://gbdev.io/pandocs/Timer_Obscure_Behaviour.html#relation-between-timer-and-divider-register
-    // increment system_counter
-    ++system_counter;
-
-    // determine bit selected by TAC multiplexer
     uint8_t selected_bit = 3;
     switch (TAC_ & 0b11) {
         case 0:
@@ -24,7 +19,21 @@ void Timer::tick()
         default:
             std::unreachable();
     }
-    bool tac_bit = (system_counter & (1 << selected_bit)) and (TAC_ & 0b100);
+    return selected_bit;
+}
+
+bool Timer::tac_bit() const
+{
+    return (system_counter & (1 << selected_bit())) and (TAC_ & 0b100);
+}
+
+void Timer::tick()
+{
+    // based on https://gbdev.io/pandocs/Timer_Obscure_Behaviour.html#relation-between-timer-and-divider-register
+    // increment system_counter
+    ++system_counter;
+
+    bool tac_bit = this->tac_bit();
 
     // DIV & TAC falling edge detector
     if (not tac_bit and old_tac_bit) {
@@ -46,6 +55,62 @@ void Timer::tick()
     }
 }
 
+void Timer::tick(uint32_t t_cycles)
+{
+    while (t_cycles > 0) {
+        /* A pending TIMA reload and the first T-cycle after DIV or TAC was written (which may cause a falling edge on
+           its own, see `cycles_until_interrupt`) are run cycle by cycle. */
+        if (tima_overflow_delay > 0 or old_tac_bit != tac_bit()) {
+            tick();
+            --t_cycles;
+            continue;
+        }
+
+        if (not (TAC_ & 0b100)) {
+            system_counter += t_cycles;
+            return;
+        }
+
+        // the selected bit falls every time the system counter reaches a multiple of twice its value
+        const uint32_t period = 1u << (selected_bit() + 1);
+        const uint32_t next_edge = period - (system_counter & (period - 1));
+        const uint32_t overflow_edge = next_edge + (0xFF - TIMA_) * period;
+
+        if (t_cycles < overflow_edge) {
+            if (t_cycles >= next_edge)
+                TIMA_ += uint8_t(1 + (t_cycles - next_edge) / period);
+            system_counter += t_cycles;
+            old_tac_bit = tac_bit();
+            return;
+        }
+
+        // run up to the T-cycle before TIMA overflows, the overflow itself is detected by `tick()`
+        TIMA_ = 0xFF;
+        system_counter += overflow_edge - 1;
+        old_tac_bit = true;
+        tick();
+        t_cycles -= overflow_edge;
+    }
+}
+
+std::optional<uint32_t> Timer::cycles_until_interrupt() const
+{
+    if (tima_overflow_delay > 0)
+        return tima_overflow_delay;
+
+    // writing DIV or TAC can cause a falling edge that is not aligned to the selected bit
+    if (old_tac_bit != tac_bit())
+        return 1;
+
+    if (not (TAC_ & 0b100))
+        return std::nullopt;
+
+    // TIMA overflows on the (0x100 - TIMA)th falling edge, TMA is loaded and the interrupt requested 3 T-cycles later
+    const uint32_t period = 1u << (selected_bit() + 1);
+    const uint32_t next_edge = period - (system_counter & (period - 1));
+    return next_edge + (0xFF - TIMA_) * period + 3;
+}
+
 bool Timer::contains_address(uint16_t addr) const
 {
     return (0xFF04 <= addr and addr <= 0xFF07);
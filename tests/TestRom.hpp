@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/** A 32 KiB ROM without a memory bank controller that is assembled by the tests. The program is appended at 0x0150,
+ * which the entry point at 0x0100 jumps to, and the interrupt handlers return right away. The ROM is written to a
+ * temporary file to be loaded, which is removed again when the object is destroyed. */
+class TestRom {
+    std::vector<uint8_t> rom_ = std::vector<uint8_t>(0x8000, 0x00);
+    uint16_t end_ = 0x0150;     // the address after the last byte of the program
+    std::filesystem::path path_;
+
+    public:
+    TestRom()
+    {
+        for (uint16_t vector : { 0x40, 0x48, 0x50, 0x58, 0x60 })
+            rom_[vector] = 0xD9;    // RETI
+        at(0x0100, { 0x00, 0xC3, 0x50, 0x01 }); // NOP; JP 0x0150
+    }
+
+    TestRom(const TestRom &) = delete;
+    TestRom &operator=(const TestRom &) = delete;
+
+    ~TestRom()
+    {
+        if (not path_.empty())
+            std::filesystem::remove(path_);
+    }
+
+    /* The address the next instruction is appended at. */
+    uint16_t here() const { return end_; }
+
+    /* Appends the given machine code to the program. */
+    TestRom &emit(std::initializer_list<uint8_t> code)
+    {
+        at(end_, code);
+        end_ += uint16_t(code.size());
+        return *this;
+    }
+
+    /* LD A, value; LDH (reg), A */
+    TestRom &write_register(uint8_t reg, uint8_t value) { return emit({ 0x3E, value, 0xE0, reg }); }
+
+    /* Waits until LY equals (or differs from) the given line: LDH A, (LY); CP line; JR NZ/Z, -6 */
+    TestRom &wait_ly(uint8_t line, bool equal = true)
+    {
+        return emit({ 0xF0, 0x44, 0xFE, line, uint8_t(equal ? 0x20 : 0x28), 0xFA });
+    }
+
+    /* Copies `count` (1-256) bytes from `source` to `destination` (LD HL, destination; LD DE, source; then LD A, (DE);
+       LD (HL+), A; INC DE; LD A, L; CP end; JR NZ, -8 for every byte). */
+    TestRom &copy(uint16_t destination, uint16_t source, unsigned count)
+    {
+        emit({ 0x21, uint8_t(destination), uint8_t(destination >> 8), 0x11, uint8_t(source), uint8_t(source >> 8) });
+        return emit({ 0x1A, 0x22, 0x13, 0x7D, 0xFE, uint8_t(destination + count), 0x20, 0xF8 });
+    }
+
+    /* Writes the given bytes to the given address without moving the end of the program. */
+    void at(uint16_t addr, std::initializer_list<uint8_t> bytes)
+    {
+        for (uint8_t byte : bytes)
+            rom_[addr++] = byte;
+    }
+
+    /* Fills the given range (including both ends) with random bytes, e.g. as data for the program. */
+    void randomize(uint16_t begin, uint16_t end, std::mt19937 &rng)
+    {
+        std::uniform_int_distribution<int> byte(0x00, 0xFF);
+        for (unsigned addr = begin; addr <= end; ++addr)
+            rom_[addr] = uint8_t(byte(rng));
+    }
+
+    /* Writes the ROM to a temporary file with the given name and returns its path. */
+    const std::filesystem::path &write(const std::string &name)
+    {
+        path_ = std::filesystem::temp_directory_path() / name;
+        std::ofstream file(path_, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(rom_.data()), std::streamsize(rom_.size()));
+        return path_;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,134 @@
+/* Tests the link cable between two Game Boys that run on their own threads (see `LinkCable`):
+   - a Game Boy with the internal clock and one with the external clock exchange their bytes, exactly with the exact
+     quantum and in order with a larger one
+   - two Game Boys that both send with the internal clock each receive 0xFF instead of waiting for each other forever,
+     no matter how large the quantum is
+
+   Usage: link_cable_test */
+
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "LinkCable.hpp"
+#include "TestRom.hpp"
+#include "YumeBoy.hpp"
+
+
+namespace {
+
+constexpr uint8_t SB = 0x01, SC = 0x02;
+constexpr uint8_t TRANSFERS = 16;
+
+/* Generates a ROM that starts `TRANSFERS` transfers with the given clock, one after another. The first byte sent is
+   `first`, every following byte is derived from the byte received by the previous transfer: the received byte plus
+   one with the internal clock, its complement with the external clock. In between, it waits `delay` (at least 1)
+   loops of 28 T-cycles. */
+void generate(TestRom &rom, bool internal_clock, uint8_t first, uint16_t delay)
+{
+    rom.emit({ 0xF3 });                 // DI
+    rom.emit({ 0x06, TRANSFERS });      // LD B, TRANSFERS
+    rom.write_register(SB, first);
+
+    const uint16_t transfer = rom.here();
+    rom.write_register(SC, internal_clock ? 0x81 : 0x80);
+    rom.emit({ 0xF0, SC, 0xCB, 0x7F, 0x20, 0xFA });     // LDH A, (SC); BIT 7, A; JR NZ, -6
+    // LD DE, delay; DEC DE; LD A, D; OR E; JR NZ, -5
+    rom.emit({ 0x11, uint8_t(delay), uint8_t(delay >> 8), 0x1B, 0x7A, 0xB3, 0x20, 0xFB });
+    rom.emit({ 0xF0, SB, uint8_t(internal_clock ? 0x3C : 0x2F), 0xE0, SB });   // LDH A, (SB); INC A / CPL; LDH (SB), A
+    auto offset = uint8_t(transfer - (rom.here() + 3));
+    rom.emit({ 0x05, 0x20, offset });   // DEC B; JR NZ, transfer
+    rom.emit({ 0x18, 0xFE });           // JR -2
+}
+
+/* A Game Boy running a generated ROM, whose sink keeps the bytes it sent. */
+struct LinkedGameBoy {
+    TestRom rom;
+    BufferSerialSink *sent;
+    std::unique_ptr<YumeBoy> yume_boy;
+
+    LinkedGameBoy(const std::string &name, bool internal_clock, uint8_t first, uint16_t delay)
+    {
+        generate(rom, internal_clock, first, delay);
+        auto sink = std::make_unique<BufferSerialSink>();
+        sent = sink.get();
+        yume_boy = std::make_unique<YumeBoy>(rom.write(name).string(), true, nullptr, nullptr, std::move(sink));
+        yume_boy->speed(0);
+    }
+};
+
+/* Runs both Game Boys until they have sent all bytes. With a large quantum, the reply to a transfer may only arrive
+   at the end of a quantum, so this can take a few frames per transfer. */
+void run(LinkedGameBoy &first, LinkedGameBoy &second, uint64_t quantum)
+{
+    LinkCable cable(*first.yume_boy, *second.yume_boy, quantum);
+    for (unsigned frame = 0; frame < 8 * TRANSFERS; ++frame) {
+        if (first.sent->text().size() == TRANSFERS and second.sent->text().size() == TRANSFERS)
+            break;
+        cable.run(LCD::FRAME_T_CYCLES);
+    }
+}
+
+std::string hex(const std::string &bytes)
+{
+    std::string text;
+    for (char byte : bytes)
+        text += std::format("{:02X} ", uint8_t(byte));
+    return text;
+}
+
+bool check(const std::string &test, const char *game_boy, const std::string &sent, const std::string &expected)
+{
+    if (sent == expected)
+        return true;
+    std::cerr << std::format("{}: the {} Game Boy sent {}instead of {}\n", test, game_boy, hex(sent), hex(expected));
+    return false;
+}
+
+/* The Game Boy with the internal clock sends 0x10 first, the one with the external clock 0x50. A late transfer may
+   complete up to two quanta after its T-cycle, so the sender waits longer than that before the next transfer, or it
+   could find the receiver still busy with the byte before. */
+bool master_and_slave(uint64_t quantum)
+{
+    const std::string test = std::format("internal and external clock (quantum {})", quantum);
+    LinkedGameBoy master("link_cable_test_master.gb", true, 0x10, uint16_t(2 * quantum / 28 + 50));
+    LinkedGameBoy slave("link_cable_test_slave.gb", false, 0x50, 1);
+    run(master, slave, quantum);
+
+    std::string master_bytes(1, char(0x10)), slave_bytes(1, char(0x50));
+    for (int i = 1; i < TRANSFERS; ++i) {
+        master_bytes += char(uint8_t(slave_bytes[i - 1]) + 1);
+        slave_bytes += char(~uint8_t(master_bytes[i - 1]));
+    }
+    return check(test, "internal clock", master.sent->text(), master_bytes)
+        and check(test, "external clock", slave.sent->text(), slave_bytes);
+}
+
+/* Both Game Boys send with the internal clock, with different delays so their transfers overlap in different ways.
+   Nobody shifts the bits in, so every byte received is 0xFF. */
+bool two_senders(uint64_t quantum)
+{
+    const std::string test = std::format("two senders (quantum {})", quantum);
+    LinkedGameBoy first("link_cable_test_first.gb", true, 0x10, 20);
+    LinkedGameBoy second("link_cable_test_second.gb", true, 0x50, 90);
+    run(first, second, quantum);
+
+    return check(test, "first", first.sent->text(), char(0x10) + std::string(TRANSFERS - 1, char(0x00)))
+        and check(test, "second", second.sent->text(), char(0x50) + std::string(TRANSFERS - 1, char(0x00)));
+}
+
+}
+
+int main()
+{
+    bool passed = true;
+    for (uint64_t quantum : { LinkCable::EXACT_QUANTUM, 3 * LinkCable::EXACT_QUANTUM, uint64_t(LCD::FRAME_T_CYCLES) }) {
+        passed = master_and_slave(quantum) and passed;
+        passed = two_senders(quantum) and passed;
+    }
+
+    std::cout << (passed ? "The link cable exchanged all bytes\n" : "The link cable failed\n");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,124 @@
+/* Differential test of the renderers of the PPU: every ROM is run by a Game Boy with the scanline renderer and one with
+   the pixel FIFO, in both execution modes. They have to present the same frames and end up in the same state.
+
+   Usage: renderer_test [ROM files...]
+   Besides the given ROMs (see YUMEBOY_TEST_ROMS), ROMs are generated that move random sprites, the window and the
+   background around and write the LCD registers in the middle of the frame, which may hit the pixel transfer. */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <utility>
+#include "TestRom.hpp"
+#include "YumeBoyCore.hpp"
+
+
+namespace {
+
+constexpr uint8_t LCDC = 0x40, SCY = 0x42, SCX = 0x43, BGP = 0x47, OBP0 = 0x48, OBP1 = 0x49, WY = 0x4A, WX = 0x4B;
+
+/* Generates a ROM that copies random tiles and tile maps to VRAM. Then, during every V-Blank, it copies random sprites
+   to OAM and writes random values to a few of the LCD registers, in some frames in the middle of the frame as well. */
+void generate(TestRom &rom, std::mt19937 &rng)
+{
+    auto random = [&rng](int begin, int end) { return std::uniform_int_distribution<int>(begin, end)(rng); };
+    rom.randomize(0x4000, 0x7FFF, rng);
+
+    rom.emit({ 0x31, 0xF0, 0xDF });     // LD SP, 0xDFF0
+    rom.write_register(LCDC, 0x00);
+    // LD HL, 0x8000; LD DE, 0x4000; then LD A, (DE); LD (HL+), A; INC DE; LD A, H; CP 0xA0; JR NZ, -8 until VRAM is full
+    rom.emit({ 0x21, 0x00, 0x80, 0x11, 0x00, 0x40, 0x1A, 0x22, 0x13, 0x7C, 0xFE, 0xA0, 0x20, 0xF8 });
+    rom.write_register(BGP, 0xE4).write_register(OBP0, 0xD2).write_register(OBP1, 0x1B);
+    rom.write_register(LCDC, 0x93);
+
+    const uint16_t loop = rom.here();
+    auto write_random_register = [&] {
+        constexpr uint8_t registers[] = { LCDC, SCY, SCX, BGP, OBP0, OBP1, WY, WX };
+        uint8_t reg = registers[random(0, std::size(registers) - 1)];
+        auto value = uint8_t(random(0x00, 0xFF));
+        if (reg == LCDC)
+            value |= 0x80;  // keep the LCD on
+        else if (reg == WY and random(0, 9) < 7)
+            value = uint8_t(random(0, 143));
+        else if (reg == WX and random(0, 9) < 7)
+            value = uint8_t(random(0, 23));
+        rom.write_register(reg, value);
+    };
+    while (rom.here() < 0x3F00) {
+        rom.wait_ly(144);
+        rom.copy(0xFE00, uint16_t(random(0x4000, 0x7F00)), 40 * random(2, 4));
+        for (int n = random(0, 3); n > 0; --n)
+            write_random_register();
+        rom.wait_ly(144, false);
+
+        if (random(0, 9) < 3) {
+            rom.wait_ly(uint8_t(random(0, 143)));
+            for (int n = random(1, 5); n > 0; --n) {
+                write_random_register();
+                for (int nops = random(0, 7); nops > 0; --nops)
+                    rom.emit({ 0x00 });
+            }
+        }
+    }
+    rom.emit({ 0xC3, uint8_t(loop), uint8_t(loop >> 8) });
+}
+
+/* Runs the ROM with both renderers for the given number of frames, returns false if they differ. */
+bool compare(const std::filesystem::path &path, YumeBoy::ExecutionMode mode, unsigned frames)
+{
+    const char *mode_name = mode == YumeBoy::ExecutionMode::Fast ? "fast" : "accurate";
+    YumeBoyCore scanline, fifo;
+    for (auto [core, renderer] : { std::pair(&scanline, PPU::Renderer::Scanline), std::pair(&fifo, PPU::Renderer::FIFO) }) {
+        core->load_rom(path.string(), true);
+        core->yume_boy().execution_mode(mode);
+        core->yume_boy().speed(0);
+        core->yume_boy().renderer(renderer);
+    }
+
+    for (unsigned frame = 0; frame < frames; ++frame) {
+        scanline.run_frame();
+        fifo.run_frame();
+        const YumeBoyCore::Frame &expected = fifo.framebuffer(), &actual = scanline.framebuffer();
+        if (actual != expected) {
+            auto pixel = size_t(std::ranges::mismatch(actual, expected).in1 - actual.begin()) / 4;
+            std::cerr << std::format("{} ({} mode): frame {} differs at ({}, {})\n", path.filename().string(), mode_name,
+                                     frame, pixel % VideoSink::WIDTH, pixel / VideoSink::WIDTH);
+            return false;
+        }
+    }
+
+    if (scanline.save_state() != fifo.save_state()) {
+        std::cerr << std::format("{} ({} mode): the states differ after {} frames\n", path.filename().string(),
+                                 mode_name, frames);
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    constexpr unsigned GENERATED_ROMS = 8;
+    constexpr unsigned GENERATED_ROM_FRAMES = 120;
+    constexpr unsigned ROM_FRAMES = 600;
+
+    bool passed = true;
+    for (auto mode : { YumeBoy::ExecutionMode::Accurate, YumeBoy::ExecutionMode::Fast }) {
+        for (unsigned seed = 0; seed < GENERATED_ROMS; ++seed) {
+            std::mt19937 rng(seed);
+            TestRom rom;
+            generate(rom, rng);
+            passed = compare(rom.write(std::format("renderer_test_{}.gb", seed)), mode, GENERATED_ROM_FRAMES) and passed;
+        }
+        for (int i = 1; i < argc; ++i)
+            passed = compare(argv[i], mode, ROM_FRAMES) and passed;
+    }
+
+    std::cout << (passed ? "The renderers produced the same frames\n" : "The renderers differ\n");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}